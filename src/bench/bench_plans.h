@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+#include "core/data.h"
+
+// synthetic plans shared by the benchmark executables
+
+// width x height grid of unit rooms named room_<x>_<y>, room types cycle along the diagonals
+// and every horizontal neighbour pair is connected by a door on the shared wall.
+// with outside_doors the last room of every row also gets a door to the outside, one door per room
+inline lmcore::FloorPlan make_grid_plan(uint32_t width, uint32_t height, bool outside_doors = false)
+{
+    lmcore::FloorPlan plan;
+    plan.rooms.reserve(size_t(width) * height);
+    plan.openings.reserve(size_t(width) * height);
+    for(uint32_t y = 0; y < height; y++)
+    {
+        for(uint32_t x = 0; x < width; x++)
+        {
+            float fx = float(x);
+            float fy = float(y);
+            lmcore::FPRoom room;
+            room.name = "room_" + std::to_string(x) + "_" + std::to_string(y);
+            room.type = lmcore::ERoomType((x + y) % uint32_t(lmcore::ERoomType::ENUM_MAX));
+            lmcore::FPGeometry geo;
+            for(auto p : {lmcore::Vec2f(fx, fy), lmcore::Vec2f(fx + 1.f, fy), lmcore::Vec2f(fx + 1.f, fy + 1.f), lmcore::Vec2f(fx, fy + 1.f)})
+            {
+                lmcore::FPPoint pt;
+                pt.value = {p.x(), p.y(), 0.f};
+                geo.points.push_back(pt);
+            }
+            room.geometries.push_back(std::move(geo));
+            plan.rooms.push_back(std::move(room));
+
+            if(x + 1 < width || outside_doors)
+            {
+                lmcore::FPOpening door;
+                door.name = "door_" + std::to_string(y * width + x);
+                door.type = lmcore::EOpeningType::Door;
+                door.position.value = {fx + 1.f, fy + 0.5f, 0.f};
+                door.bounding.xyz = {0.1f, 0.4f, 1.1f};
+                door.connection.first = int32_t(y * width + x);
+                if(x + 1 < width)
+                    door.connection.second = int32_t(y * width + x + 1);
+                else
+                    door.connection.out = true;
+                plan.openings.push_back(std::move(door));
+            }
+        }
+    }
+    lmcore::build_room_index(plan);
+    return plan;
+}
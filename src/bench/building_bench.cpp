@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench/bench_plans.h"
+#include "system/framePacing.h"
+#include "utils/building.h"
+#include "utils/planLoader.h"
+#include "utils/planWriter.h"
+
+// flies a camera up and down a tall building and reports how Building pages storeys in and out.
+// one storey file is truncated and one is missing on purpose, both have to end up failed without stopping the others
+
+namespace fs = std::filesystem;
+
+int main()
+{
+    const uint32_t storeyCount = 50;
+    const uint32_t brokenStorey = 17;
+    const uint32_t missingStorey = 33;
+    const float storeyHeight = 3.f;
+    const size_t gpuBytesPerRoom = 4096;
+
+    fs::path dir = fs::temp_directory_path() / "laymann_building_bench";
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+
+    auto plan = make_grid_plan(40, 40);
+    std::string text = lmv::serialize_floor_plan_json(plan);
+    std::vector<std::string> paths;
+    for(uint32_t i = 0; i < storeyCount; i++)
+    {
+        auto path = (dir / ("storey_" + std::to_string(i) + ".json")).string();
+        if(!lmv::write_floor_plan_json(path, plan))
+        {
+            std::fprintf(stderr, "building_bench: cannot write '%s'\n", path.c_str());
+            return 1;
+        }
+        paths.push_back(path);
+    }
+    fs::resize_file(paths[brokenStorey], text.size() / 2, ec);
+    fs::remove(paths[missingStorey], ec);
+
+    // room for about a dozen storeys, more than the resident radius keeps in use at once
+    size_t storeyBytes = lmv::estimate_plan_bytes(lmv::parse_floor_plan(js::parse(text))) + plan.rooms.size() * gpuBytesPerRoom;
+    lmv::BuildingOptions options;
+    options.memory_budget = storeyBytes * 12;
+    options.resident_radius = 3.5f * storeyHeight;
+
+    lmv::Building building(options);
+    for(uint32_t i = 0; i < storeyCount; i++)
+        building.add_storey(paths[i], float(i) * storeyHeight);
+
+    uint64_t residentCalls = 0;
+    uint64_t evictCalls = 0;
+    building.set_hooks({
+        [&](uint32_t, const lmcore::FloorPlan & p, float) { residentCalls++; return p.rooms.size() * gpuBytesPerRoom; },
+        [&](uint32_t) { evictCalls++; }
+    });
+
+    // two round trips from the ground floor to the roof at 0.5 m per frame
+    std::vector<double> updateMs;
+    size_t peakBytes = 0;
+    float top = float(storeyCount - 1) * storeyHeight;
+    const float step = 0.5f;
+    uint32_t framesPerLeg = uint32_t(top / step);
+    for(uint32_t leg = 0; leg < 4; leg++)
+    {
+        for(uint32_t f = 0; f <= framesPerLeg; f++)
+        {
+            float z = (leg % 2 == 0) ? float(f) * step : top - float(f) * step;
+            auto t0 = std::chrono::steady_clock::now();
+            building.update(lmcore::Vec3f(0.f, 0.f, z));
+            auto t1 = std::chrono::steady_clock::now();
+            updateMs.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+            peakBytes = std::max(peakBytes, building.get_stats().resident_bytes);
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    }
+
+    // the sweep drops requests the camera passed before a loader got to them, so finish by parking
+    // at every storey until its neighbourhood is loaded. every storey is requested at least once
+    for(uint32_t i = 0; i < storeyCount; i++)
+    {
+        lmcore::Vec3f camera(0.f, 0.f, float(i) * storeyHeight);
+        building.update(camera);
+        for(int wait = 0; wait < 5000 && building.get_stats().pending > 0; wait++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            building.update(camera);
+        }
+        peakBytes = std::max(peakBytes, building.get_stats().resident_bytes);
+    }
+
+    auto stats = building.get_stats();
+    auto frames = lmv::computeFrameTimeStats(updateMs);
+    std::printf("%u storeys, budget %.1f MB, peak resident %.1f MB, resident now %u (%.1f MB)\n", stats.storeys,
+        double(stats.budget_bytes) * 1e-6, double(peakBytes) * 1e-6, stats.resident, double(stats.resident_bytes) * 1e-6);
+    std::printf("loads %llu, evictions %llu, hits %llu, misses %llu, failed %u, hooks %llu/%llu\n",
+        (unsigned long long)stats.loads, (unsigned long long)stats.evictions, (unsigned long long)stats.hits,
+        (unsigned long long)stats.misses, stats.failed, (unsigned long long)residentCalls, (unsigned long long)evictCalls);
+    std::printf("update %zu frames, mean %.3f ms, p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+        frames.frames, frames.mean, frames.p50, frames.p95, frames.p99, frames.max);
+
+    building.clear_residency();
+    fs::remove_all(dir, ec);
+
+    bool ok = stats.failed == 2 && peakBytes <= options.memory_budget && stats.evictions > 0;
+    if(!ok)
+        std::fprintf(stderr, "building_bench: unexpected residency behaviour\n");
+    return ok ? 0 : 1;
+}
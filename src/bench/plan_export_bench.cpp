@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "bench/bench_plans.h"
+#include "core/planDiff.h"
+#include "core/processor.h"
+#include "utils/planLoader.h"
+#include "utils/planWriter.h"
+
+template<typename F>
+static double best_ms(int runs, F && fn)
+{
+    double best = 1e30;
+    for(int i = 0; i < runs; i++)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        fn();
+        auto t1 = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(t1 - t0).count());
+    }
+    return best;
+}
+
+// unknown types and dangling connections have to survive both export forms, the validator reports them after reload
+static bool check_round_trip()
+{
+    auto plan = make_grid_plan(4, 4);
+    plan.rooms[0].type = lmcore::ERoomType::ENUM_MAX;
+    plan.openings[0].type = lmcore::EOpeningType::ENUM_MAX;
+    plan.openings[1].connection.second = -1;
+    plan.openings[2].connection.first = 999;
+    plan.openings[3].connection = {-1, -1, true};
+    plan.openings[4].connection = {-1, -1, false};
+
+    lmcore::FloorPlan from_binary;
+    auto bytes = lmv::serialize_floor_plan_binary(plan);
+    bool ok = lmv::parse_floor_plan_binary(bytes.data(), bytes.size(), from_binary);
+    auto from_json = lmv::parse_floor_plan(js::parse(lmv::serialize_floor_plan_json(plan)));
+
+    auto room_or_none = [](const lmcore::FloorPlan & p, int32_t room)
+    {
+        return room >= 0 && size_t(room) < p.rooms.size() ? room : -1;
+    };
+
+    for(const auto * loaded : {&from_binary, &from_json})
+    {
+        ok = ok && lmcore::diff_floor_plans(plan, *loaded).empty() && loaded->openings.size() == plan.openings.size();
+        for(size_t o = 0; ok && o < plan.openings.size(); o++)
+        {
+            const auto & a = plan.openings[o];
+            const auto & b = loaded->openings[o];
+            ok = a.type == b.type && a.connection.out == b.connection.out
+                && room_or_none(plan, a.connection.first) == room_or_none(*loaded, b.connection.first)
+                && room_or_none(plan, a.connection.second) == room_or_none(*loaded, b.connection.second);
+        }
+    }
+    return ok;
+}
+
+int main()
+{
+    if(!check_round_trip())
+    {
+        std::fprintf(stderr, "round trip check failed\n");
+        return 1;
+    }
+
+    const int runs = 3;
+    auto plan = make_grid_plan(400, 250);
+    lmcore::get_room_metrics(plan);
+    std::printf("%zu rooms, %zu openings\n", plan.rooms.size(), plan.openings.size());
+
+    lmv::PlanWriteOptions serial;
+    serial.parallel = false;
+    lmv::PlanWriteOptions parallel;
+
+    std::string text;
+    std::vector<uint8_t> bytes;
+    auto report = [](const char * label, double ms, size_t size)
+    {
+        std::printf("%-22s %10.2f ms %10.1f MB/s\n", label, ms, double(size) / (ms * 1e-3) * 1e-6);
+    };
+
+    double ms = best_ms(runs, [&]() { text = lmv::serialize_floor_plan_json(plan, serial); });
+    report("json write serial", ms, text.size());
+    ms = best_ms(runs, [&]() { text = lmv::serialize_floor_plan_json(plan, parallel); });
+    report("json write parallel", ms, text.size());
+
+    ms = best_ms(1, [&]() { lmv::parse_floor_plan(js::parse(text)); });
+    report("json read", ms, text.size());
+
+    ms = best_ms(runs, [&]() { bytes = lmv::serialize_floor_plan_binary(plan, serial); });
+    report("binary write serial", ms, bytes.size());
+    ms = best_ms(runs, [&]() { bytes = lmv::serialize_floor_plan_binary(plan, parallel); });
+    report("binary write parallel", ms, bytes.size());
+
+    lmcore::FloorPlan loaded;
+    ms = best_ms(runs, [&]() { lmv::parse_floor_plan_binary(bytes.data(), bytes.size(), loaded); });
+    report("binary read", ms, bytes.size());
+
+    // move every 97th room, drop every 1000th and rename every 5000th so it shows up as removed and added
+    auto edited = loaded;
+    for(size_t r = 0; r < edited.rooms.size(); r += 97)
+    {
+        for(auto & p : edited.rooms[r].geometries[0].points)
+            p.value.x() += 0.25f;
+    }
+    for(size_t r = 0; r < edited.rooms.size(); r += 5000)
+        edited.rooms[r].name += "_renamed";
+    for(size_t r = edited.rooms.size(); r-- > 0;)
+    {
+        if(r % 1000 == 999)
+            edited.rooms.erase(edited.rooms.begin() + r);
+    }
+    lmcore::build_room_index(edited);
+    lmcore::get_room_metrics(edited);
+
+    lmcore::FPPlanDiff diff;
+    ms = best_ms(runs, [&]() { diff = lmcore::diff_floor_plans(plan, edited); });
+    std::printf("%-22s %10.2f ms   %u added, %u removed, %u changed, %u unchanged\n", "diff", ms,
+        diff.added, diff.removed, diff.changed, diff.unchanged);
+
+    return 0;
+}
@@ -0,0 +1,39 @@
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "bench/bench_plans.h"
+#include "utils/planLoader.h"
+#include "utils/planWriter.h"
+
+int main()
+{
+    std::printf("%10s %10s %12s %12s\n", "rooms", "openings", "load ms", "ns/room");
+
+    // plain input plans, without the metrics the writer adds by default
+    lmv::PlanWriteOptions writeOptions;
+    writeOptions.metrics = false;
+
+    for(uint32_t side = 32; side <= 512; side *= 2)
+    {
+        js jdata = js::parse(lmv::serialize_floor_plan_json(make_grid_plan(side, side, true), writeOptions));
+
+        const int runs = 3;
+        double best = 1e30;
+        size_t room_count = 0;
+        size_t opening_count = 0;
+        for(int i = 0; i < runs; i++)
+        {
+            auto t0 = std::chrono::steady_clock::now();
+            auto plan = lmv::parse_floor_plan(jdata);
+            auto t1 = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::milli>(t1 - t0).count());
+            room_count = plan.rooms.size();
+            opening_count = plan.openings.size();
+        }
+
+        std::printf("%10zu %10zu %12.2f %12.1f\n", room_count, opening_count, best, best * 1e6 / double(room_count));
+    }
+
+    return 0;
+}
\ No newline at end of file
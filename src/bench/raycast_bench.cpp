@@ -0,0 +1,66 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include "bench/bench_plans.h"
+#include "core/raycast.h"
+
+int main()
+{
+    const uint32_t side = 100;
+    const uint32_t points = 2000;
+    const uint32_t raysPerPoint = 256;
+    const float maxDistance = 50.f;
+
+    auto plan = make_grid_plan(side, side);
+    auto t0 = std::chrono::steady_clock::now();
+    lmcore::RayScene scene;
+    scene.build(plan);
+    auto t1 = std::chrono::steady_clock::now();
+    std::printf("%zu rooms, %zu wall segments, build %.2f ms\n", plan.rooms.size(), scene.get_segments().size(),
+        std::chrono::duration<double, std::milli>(t1 - t0).count());
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> coord(0.05f, float(side) - 0.05f);
+    std::vector<lmcore::PLine> rays;
+    rays.reserve(size_t(points) * raysPerPoint);
+    for(uint32_t p = 0; p < points; p++)
+    {
+        lmcore::Vec2f origin(coord(rng), coord(rng));
+        for(uint32_t i = 0; i < raysPerPoint; i++)
+        {
+            float a = 2.f * float(EIGEN_PI) * float(i) / float(raysPerPoint);
+            rays.emplace_back(origin, lmcore::Vec2f(std::cos(a), std::sin(a)));
+        }
+    }
+    std::vector<lmcore::FPRayHit> hits(rays.size());
+
+    auto report = [&](const char * label, double seconds)
+    {
+        size_t hitCount = 0;
+        for(auto & h : hits)
+            hitCount += h.hit() ? 1 : 0;
+        std::printf("%-14s %10zu rays %8.2f ms %8.2f Mrays/s (%zu hits)\n", label, rays.size(), seconds * 1e3,
+            double(rays.size()) / seconds * 1e-6, hitCount);
+    };
+
+    t0 = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < rays.size(); i++)
+        hits[i] = scene.cast(rays[i], maxDistance);
+    t1 = std::chrono::steady_clock::now();
+    report("single ray", std::chrono::duration<double>(t1 - t0).count());
+
+    t0 = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < rays.size(); i += lmcore::RayScene::k_packet_size)
+        scene.cast_packet(rays.data() + i, lmcore::RayScene::k_packet_size, maxDistance, hits.data() + i);
+    t1 = std::chrono::steady_clock::now();
+    report("packets", std::chrono::duration<double>(t1 - t0).count());
+
+    t0 = std::chrono::steady_clock::now();
+    scene.cast_batch(rays, maxDistance, hits);
+    t1 = std::chrono::steady_clock::now();
+    report("batch threads", std::chrono::duration<double>(t1 - t0).count());
+
+    return 0;
+}
\ No newline at end of file
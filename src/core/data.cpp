@@ -0,0 +1,35 @@
+#include "core/data.h"
+
+namespace lmcore
+{
+    void build_room_index(FloorPlan & plan)
+    {
+        plan.room_names.clear();
+        plan.room_names.reserve(plan.rooms.size());
+        auto r_count = plan.rooms.size();
+        for(size_t i = 0; i < r_count; i++)
+            plan.room_names.insert(plan.rooms[i].name, int32_t(i));
+    }
+
+    void invalidate_plan_data(FloorPlan & plan)
+    {
+        plan.data.metrics_valid = false;
+    }
+
+    int32_t find_room(const FloorPlan & plan, std::string_view name)
+    {
+        // the index goes stale when rooms are renamed, added or removed without build_room_index,
+        // so a hit is confirmed against the room and anything else falls back to a scan
+        int32_t index = plan.room_names.find(name);
+        if(index >= 0 && size_t(index) < plan.rooms.size() && plan.rooms[index].name == name)
+            return index;
+
+        auto r_count = plan.rooms.size();
+        for(size_t i = 0; i < r_count; i++)
+        {
+            if(plan.rooms[i].name == name)
+                return int32_t(i);
+        }
+        return -1;
+    }
+}
\ No newline at end of file
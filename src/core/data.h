@@ -3,8 +3,10 @@
 #include <string>
 #include <vector>
 #include <array>
+#include <string_view>
 
 #include "core/math.h"
+#include "core/names.h"
 
 namespace lmcore
 {
@@ -73,9 +75,24 @@ namespace lmcore
         FPConnection connection;
     };
 
+    struct FPRoomMetrics
+    {
+        float area = 0.f;
+        float perimeter = 0.f;
+        Vec2f centroid = {0.f, 0.f};
+        float window_area = 0.f;
+        float window_to_floor = 0.f;
+        uint32_t door_count = 0;
+        uint32_t window_count = 0;
+    };
+
+    // derived data cached on the plan. nothing tracks edits to rooms or openings, whoever edits them
+    // calls invalidate_plan_data (validate_floor_plan does after repairing). code that may receive
+    // plans edited in place, like diff_floor_plans, recomputes instead of reading the cache
     struct FPData
     {
-        
+        std::vector<FPRoomMetrics> room_metrics;
+        bool metrics_valid = false;
     };
 
     struct FloorPlan
@@ -83,8 +100,16 @@ namespace lmcore
         std::vector<FPRoom> rooms;
         std::vector<FPOpening> openings;
         FPData data;
+        // room name -> room index, rebuild with build_room_index after editing rooms
+        NameIndex room_names;
     };
 
+    void build_room_index(FloorPlan & plan);
+    // must be called after editing rooms or openings, otherwise cached FPData stays stale
+    void invalidate_plan_data(FloorPlan & plan);
+    // uses plan.room_names when it is current, otherwise scans the rooms. a miss always costs a scan
+    int32_t find_room(const FloorPlan & plan, std::string_view name);
+
     struct PosColorVertex
     {
         float x, y, z;
@@ -0,0 +1,127 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+#include "core/data.h"
+
+namespace lmcore
+{
+    constexpr char to_lower_ascii(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? char(c - 'A' + 'a') : c;
+    }
+
+    constexpr bool iequals_ascii(std::string_view a, std::string_view b)
+    {
+        if(a.size() != b.size())
+            return false;
+        for(size_t i = 0; i < a.size(); i++)
+        {
+            if(to_lower_ascii(a[i]) != to_lower_ascii(b[i]))
+                return false;
+        }
+        return true;
+    }
+
+    // case insensitive so "door" and "Door" hash to the same slot
+    constexpr uint32_t hash_enum_name(std::string_view name, uint32_t seed)
+    {
+        uint32_t h = 2166136261u ^ seed;
+        for(char c : name)
+        {
+            h ^= uint8_t(to_lower_ascii(c));
+            h *= 16777619u;
+        }
+        return h ^ (h >> 15);
+    }
+
+    // string -> enum map with a perfect hash table, seed and table are found at compile time
+    template<typename E, size_t N>
+    struct EnumNameMap
+    {
+        static constexpr size_t k_table_size = std::bit_ceil(N * 2);
+
+        std::array<std::string_view, N> names{};
+        std::array<E, N> values{};
+        std::array<int8_t, k_table_size> table{};
+        uint32_t seed = 0;
+
+        constexpr E find(std::string_view name, E fallback) const
+        {
+            int8_t i = table[hash_enum_name(name, seed) & (k_table_size - 1)];
+            if(i >= 0 && iequals_ascii(names[i], name))
+                return values[i];
+            return fallback;
+        }
+
+        constexpr std::string_view name_of(E value) const
+        {
+            for(size_t i = 0; i < N; i++)
+            {
+                if(values[i] == value)
+                    return names[i];
+            }
+            return {};
+        }
+    };
+
+    template<typename E, size_t N>
+    constexpr EnumNameMap<E, N> make_enum_name_map(const std::array<std::pair<std::string_view, E>, N> & entries)
+    {
+        EnumNameMap<E, N> map;
+        for(size_t i = 0; i < N; i++)
+        {
+            map.names[i] = entries[i].first;
+            map.values[i] = entries[i].second;
+        }
+
+        constexpr size_t mask = EnumNameMap<E, N>::k_table_size - 1;
+        for(uint32_t seed = 0; seed < 1u << 20; seed++)
+        {
+            map.table.fill(-1);
+            bool ok = true;
+            for(size_t i = 0; i < N && ok; i++)
+            {
+                auto & slot = map.table[hash_enum_name(map.names[i], seed) & mask];
+                ok = slot < 0;
+                slot = int8_t(i);
+            }
+            if(ok)
+            {
+                map.seed = seed;
+                return map;
+            }
+        }
+        throw "no perfect hash seed found";
+    }
+
+    inline constexpr auto k_room_type_names = make_enum_name_map<ERoomType, 5>({{
+        {"LivingRoom", ERoomType::LivingRoom},
+        {"Bedroom", ERoomType::Bedroom},
+        {"DiningRoom", ERoomType::DiningRoom},
+        {"Kitchen", ERoomType::Kitchen},
+        {"Bathroom", ERoomType::Bathroom},
+    }});
+
+    inline constexpr auto k_opening_type_names = make_enum_name_map<EOpeningType, 2>({{
+        {"Door", EOpeningType::Door},
+        {"Window", EOpeningType::Window},
+    }});
+
+    constexpr ERoomType room_type_from_name(std::string_view name)
+    {
+        return k_room_type_names.find(name, ERoomType::ENUM_MAX);
+    }
+
+    constexpr EOpeningType opening_type_from_name(std::string_view name)
+    {
+        return k_opening_type_names.find(name, EOpeningType::ENUM_MAX);
+    }
+
+    static_assert(room_type_from_name("Kitchen") == ERoomType::Kitchen);
+    static_assert(room_type_from_name("Garage") == ERoomType::ENUM_MAX);
+    static_assert(opening_type_from_name("door") == EOpeningType::Door);
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+#include "core/names.h"
+
+namespace lmcore
+{
+    void NameIndex::clear()
+    {
+        slots.clear();
+        pool.clear();
+        offsets.clear();
+        values.clear();
+    }
+
+    void NameIndex::reserve(size_t count)
+    {
+        offsets.reserve(count + 1);
+        values.reserve(count);
+        // keep the load factor at or below one half
+        size_t slot_count = 16;
+        while(slot_count < count * 2)
+            slot_count <<= 1;
+        if(slot_count > slots.size())
+            rehash(slot_count);
+    }
+
+    std::string_view NameIndex::name(uint32_t id) const
+    {
+        return std::string_view(pool.data() + offsets[id], offsets[id + 1] - offsets[id]);
+    }
+
+    void NameIndex::rehash(size_t slot_count)
+    {
+        std::vector<Slot> next(slot_count);
+        size_t mask = slot_count - 1;
+        for(auto & s : slots)
+        {
+            if(s.id == k_empty)
+                continue;
+            size_t i = s.hash & mask;
+            while(next[i].id != k_empty)
+                i = (i + 1) & mask;
+            next[i] = s;
+        }
+        slots.swap(next);
+    }
+
+    bool NameIndex::insert(std::string_view name, int32_t value)
+    {
+        if((values.size() + 1) * 2 > slots.size())
+            rehash(slots.empty() ? 16 : slots.size() * 2);
+
+        if(offsets.empty())
+            offsets.push_back(0);
+
+        uint32_t h = uint32_t(hash_name(name));
+        size_t mask = slots.size() - 1;
+        size_t i = h & mask;
+        while(slots[i].id != k_empty)
+        {
+            if(slots[i].hash == h && this->name(slots[i].id) == name)
+                return false;
+            i = (i + 1) & mask;
+        }
+
+        slots[i].hash = h;
+        slots[i].id = uint32_t(values.size());
+        pool.append(name);
+        offsets.push_back(uint32_t(pool.size()));
+        values.push_back(value);
+        return true;
+    }
+
+    int32_t NameIndex::find(std::string_view name) const
+    {
+        if(slots.empty())
+            return -1;
+
+        uint32_t h = uint32_t(hash_name(name));
+        size_t mask = slots.size() - 1;
+        size_t i = h & mask;
+        while(slots[i].id != k_empty)
+        {
+            if(slots[i].hash == h && this->name(slots[i].id) == name)
+                return values[slots[i].id];
+            i = (i + 1) & mask;
+        }
+        return -1;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lmcore
+{
+    // FNV-1a, stable across runs so hashes can be stored or compared between plans
+    constexpr uint64_t hash_name(std::string_view name)
+    {
+        uint64_t h = 14695981039346656037ull;
+        for(char c : name)
+        {
+            h ^= uint8_t(c);
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    // interned name table with an open addressing (linear probing) hash index.
+    // names are copied into one contiguous pool, every name maps to one int32_t value
+    class NameIndex
+    {
+    public:
+        void clear();
+        void reserve(size_t count);
+
+        // returns false and keeps the existing value if the name is already present
+        bool insert(std::string_view name, int32_t value);
+        // returns -1 if the name is unknown
+        int32_t find(std::string_view name) const;
+
+        size_t size() const { return values.size(); }
+        bool empty() const { return values.empty(); }
+
+        // views stay valid until the next insert
+        std::string_view name(uint32_t id) const;
+        int32_t value(uint32_t id) const { return values[id]; }
+
+        size_t memory_bytes() const
+        {
+            return slots.capacity() * sizeof(Slot) + pool.capacity() + offsets.capacity() * sizeof(uint32_t) + values.capacity() * sizeof(int32_t);
+        }
+
+    private:
+        static constexpr uint32_t k_empty = 0xffffffffu;
+
+        struct Slot
+        {
+            uint32_t hash = 0;
+            uint32_t id = k_empty;
+        };
+
+        void rehash(size_t slot_count);
+
+        std::vector<Slot> slots;
+        std::string pool;
+        std::vector<uint32_t> offsets;
+        std::vector<int32_t> values;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace lmcore
+{
+    inline uint32_t get_worker_count()
+    {
+        uint32_t n = std::thread::hardware_concurrency();
+        return n > 0 ? n : 1;
+    }
+
+    // splits [0,count) into contiguous chunks, one per worker.
+    // fn(begin, end, worker) is called once per non-empty chunk, worker indices are
+    // ordered like the chunks so per-worker results can be concatenated deterministically
+    template<typename F>
+    uint32_t parallel_for(size_t count, F && fn, size_t min_grain = 256)
+    {
+        if(count == 0)
+            return 0;
+
+        size_t workers = std::min<size_t>(get_worker_count(), (count + min_grain - 1) / min_grain);
+        workers = std::max<size_t>(workers, 1);
+
+        if(workers == 1)
+        {
+            fn(size_t(0), count, uint32_t(0));
+            return 1;
+        }
+
+        size_t chunk = (count + workers - 1) / workers;
+        std::vector<std::thread> threads;
+        threads.reserve(workers - 1);
+
+        for(size_t w = 1; w < workers; w++)
+        {
+            size_t begin = w * chunk;
+            size_t end = std::min(count, begin + chunk);
+            if(begin >= end)
+                break;
+            threads.emplace_back([&fn, begin, end, w]() { fn(begin, end, uint32_t(w)); });
+        }
+
+        fn(size_t(0), std::min(count, chunk), uint32_t(0));
+
+        for(auto & t : threads)
+            t.join();
+
+        return uint32_t(workers);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,156 @@
+#include "core/planDiff.h"
+#include "core/parallel.h"
+#include "core/processor.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace lmcore
+{
+    namespace
+    {
+        // always rebuilt, plan.room_names goes stale when rooms are renamed or reordered in place
+        // and edited plans are exactly what gets diffed
+        void build_index(const FloorPlan & plan, NameIndex & index)
+        {
+            index.reserve(plan.rooms.size());
+            auto r_count = plan.rooms.size();
+            for(size_t i = 0; i < r_count; i++)
+                index.insert(plan.rooms[i].name, int32_t(i));
+        }
+
+        uint32_t compare_geometry(const FPRoom & a, const FPRoom & b, float tolerance, float & max_delta)
+        {
+            max_delta = 0.f;
+            if(a.geometries.size() != b.geometries.size())
+                return RoomChangeTopology;
+
+            auto g_count = a.geometries.size();
+            for(size_t g = 0; g < g_count; g++)
+            {
+                if(a.geometries[g].points.size() != b.geometries[g].points.size())
+                    return RoomChangeTopology;
+            }
+
+            float max_sq = 0.f;
+            for(size_t g = 0; g < g_count; g++)
+            {
+                const auto & pa = a.geometries[g].points;
+                const auto & pb = b.geometries[g].points;
+                auto p_count = pa.size();
+                for(size_t i = 0; i < p_count; i++)
+                {
+                    float dx = pb[i].value.x() - pa[i].value.x();
+                    float dy = pb[i].value.y() - pa[i].value.y();
+                    max_sq = std::max(max_sq, dx * dx + dy * dy);
+                }
+            }
+            max_delta = std::sqrt(max_sq);
+            return max_delta > tolerance ? RoomChangeGeometry : 0u;
+        }
+
+        struct WorkerResult
+        {
+            std::vector<FPRoomDelta> rooms;
+            uint32_t added = 0;
+            uint32_t removed = 0;
+            uint32_t changed = 0;
+            uint32_t unchanged = 0;
+        };
+    }
+
+    const char * room_change_name(ERoomChange change)
+    {
+        switch(change)
+        {
+            case ERoomChange::Added: return "Added";
+            case ERoomChange::Removed: return "Removed";
+            case ERoomChange::Changed: return "Changed";
+            default: return "Unknown";
+        }
+    }
+
+    FPPlanDiff diff_floor_plans(const FloorPlan & before, const FloorPlan & after, const FPDiffOptions & options)
+    {
+        NameIndex before_names, after_names;
+        build_index(before, before_names);
+        build_index(after, after_names);
+
+        // plan.data is not read for the same reason, an in place edit may not have invalidated it
+        std::vector<FPRoomMetrics> before_metrics, after_metrics;
+        compute_room_metrics(before, before_metrics);
+        compute_room_metrics(after, after_metrics);
+
+        std::vector<WorkerResult> removed(get_worker_count());
+        parallel_for(before.rooms.size(), [&](size_t begin, size_t end, uint32_t worker)
+        {
+            auto & out = removed[worker];
+            for(size_t r = begin; r < end; r++)
+            {
+                if(after_names.find(before.rooms[r].name) >= 0)
+                    continue;
+                FPRoomDelta delta;
+                delta.change = ERoomChange::Removed;
+                delta.before = int32_t(r);
+                out.rooms.push_back(delta);
+                out.removed++;
+            }
+        }, 1024);
+
+        std::vector<WorkerResult> matched(get_worker_count());
+        parallel_for(after.rooms.size(), [&](size_t begin, size_t end, uint32_t worker)
+        {
+            auto & out = matched[worker];
+            for(size_t r = begin; r < end; r++)
+            {
+                const FPRoom & room = after.rooms[r];
+                int32_t b = before_names.find(room.name);
+
+                FPRoomDelta delta;
+                delta.after = int32_t(r);
+                if(b < 0)
+                {
+                    delta.change = ERoomChange::Added;
+                    out.rooms.push_back(delta);
+                    out.added++;
+                    continue;
+                }
+
+                const FPRoom & old = before.rooms[b];
+                delta.change = ERoomChange::Changed;
+                delta.before = b;
+                delta.flags = compare_geometry(old, room, options.tolerance, delta.max_vertex_delta);
+                if(old.type != room.type)
+                    delta.flags |= RoomChangeType;
+
+                if(delta.flags == 0)
+                {
+                    out.unchanged++;
+                    continue;
+                }
+
+                const FPRoomMetrics & m0 = before_metrics[b];
+                const FPRoomMetrics & m1 = after_metrics[r];
+                delta.area_delta = m1.area - m0.area;
+                delta.perimeter_delta = m1.perimeter - m0.perimeter;
+                delta.centroid_delta = m1.centroid - m0.centroid;
+                out.rooms.push_back(delta);
+                out.changed++;
+            }
+        }, 1024);
+
+        FPPlanDiff diff;
+        for(auto * results : {&removed, &matched})
+        {
+            for(auto & w : *results)
+            {
+                diff.rooms.insert(diff.rooms.end(), w.rooms.begin(), w.rooms.end());
+                diff.added += w.added;
+                diff.removed += w.removed;
+                diff.changed += w.changed;
+                diff.unchanged += w.unchanged;
+            }
+        }
+        return diff;
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "core/data.h"
+
+namespace lmcore
+{
+    enum class ERoomChange
+    {
+        Added = 0,
+        Removed,
+        Changed,
+
+        ENUM_MAX
+    };
+
+    // what differs on a changed room, combined as bit flags
+    enum ERoomChangeFlags : uint32_t
+    {
+        RoomChangeType = 1u << 0,
+        // ring or vertex count differs, vertices are not compared
+        RoomChangeTopology = 1u << 1,
+        RoomChangeGeometry = 1u << 2
+    };
+
+    struct FPRoomDelta
+    {
+        ERoomChange change;
+        uint32_t flags = 0;
+        int32_t before = -1;
+        int32_t after = -1;
+
+        // after minus before, zero for added and removed rooms
+        float area_delta = 0.f;
+        float perimeter_delta = 0.f;
+        Vec2f centroid_delta = {0.f, 0.f};
+        // largest vertex displacement, only measured when the topology matches
+        float max_vertex_delta = 0.f;
+    };
+
+    struct FPDiffOptions
+    {
+        // vertices that moved less than this are considered unchanged
+        float tolerance = 1e-4f;
+    };
+
+    struct FPPlanDiff
+    {
+        // removed rooms first in before order, then added and changed rooms in after order
+        std::vector<FPRoomDelta> rooms;
+        uint32_t added = 0;
+        uint32_t removed = 0;
+        uint32_t changed = 0;
+        uint32_t unchanged = 0;
+
+        bool empty() const { return rooms.empty(); }
+    };
+
+    const char * room_change_name(ERoomChange change);
+
+    // matches rooms of the two plans by name through a name hash index rebuilt from the rooms and compares type
+    // and geometry. plan.room_names and plan.data are not trusted, metrics are recomputed. rooms are compared in parallel
+    FPPlanDiff diff_floor_plans(const FloorPlan & before, const FloorPlan & after, const FPDiffOptions & options = {});
+}
@@ -0,0 +1,207 @@
+#include "core/processor.h"
+#include "core/parallel.h"
+#include "core/simd.h"
+
+#include <cmath>
+
+namespace lmcore
+{
+    namespace
+    {
+        struct MetricsScratch
+        {
+            // one entry per ring edge, (x, y) -> (xn, yn)
+            std::vector<float> x, y, xn, yn;
+            std::vector<float> cross, length, cx, cy;
+            // exclusive end edge of every ring and exclusive end ring of every room
+            std::vector<uint32_t> ring_end;
+            std::vector<uint32_t> room_end;
+
+            void clear()
+            {
+                x.clear(); y.clear(); xn.clear(); yn.clear();
+                ring_end.clear();
+                room_end.clear();
+            }
+        };
+
+        void gather_edges(const FloorPlan & plan, size_t begin, size_t end, MetricsScratch & s)
+        {
+            s.clear();
+            for(size_t r = begin; r < end; r++)
+            {
+                for(auto & geo : plan.rooms[r].geometries)
+                {
+                    auto n = geo.points.size();
+                    for(size_t i = 0; i < n; i++)
+                    {
+                        const Vec3f & p = geo.points[i].value;
+                        const Vec3f & q = geo.points[i + 1 < n ? i + 1 : 0].value;
+                        s.x.push_back(p.x());
+                        s.y.push_back(p.y());
+                        s.xn.push_back(q.x());
+                        s.yn.push_back(q.y());
+                    }
+                    s.ring_end.push_back(uint32_t(s.x.size()));
+                }
+                s.room_end.push_back(uint32_t(s.ring_end.size()));
+            }
+        }
+
+        void room_geometry_metrics(const FloorPlan & plan, size_t begin, size_t end, FPRoomMetrics * out, MetricsScratch & s)
+        {
+            gather_edges(plan, begin, end, s);
+
+            // per edge terms 4 edges at a time through core/simd.h. std::sqrt sets errno, so a plain
+            // loop is not auto vectorized without -fno-math-errno
+            size_t n = s.x.size();
+            s.cross.resize(n);
+            s.length.resize(n);
+            s.cx.resize(n);
+            s.cy.resize(n);
+            const float * x = s.x.data();
+            const float * y = s.y.data();
+            const float * xn = s.xn.data();
+            const float * yn = s.yn.data();
+            float * cross = s.cross.data();
+            float * length = s.length.data();
+            float * cx = s.cx.data();
+            float * cy = s.cy.data();
+
+            size_t i = 0;
+            for(; i + 4 <= n; i += 4)
+            {
+                f32x4 px = f32x4::load(x + i);
+                f32x4 py = f32x4::load(y + i);
+                f32x4 qx = f32x4::load(xn + i);
+                f32x4 qy = f32x4::load(yn + i);
+                f32x4 c = px * qy - qx * py;
+                f32x4 dx = qx - px;
+                f32x4 dy = qy - py;
+                c.store(cross + i);
+                sqrt(dx * dx + dy * dy).store(length + i);
+                ((px + qx) * c).store(cx + i);
+                ((py + qy) * c).store(cy + i);
+            }
+            for(; i < n; i++)
+            {
+                float c = x[i] * yn[i] - xn[i] * y[i];
+                float dx = xn[i] - x[i];
+                float dy = yn[i] - y[i];
+                cross[i] = c;
+                length[i] = std::sqrt(dx * dx + dy * dy);
+                cx[i] = (x[i] + xn[i]) * c;
+                cy[i] = (y[i] + yn[i]) * c;
+            }
+
+            // segmented reduction, rings of one room are summed by their absolute area
+            uint32_t e = 0;
+            uint32_t ring = 0;
+            for(size_t k = 0; k < end - begin; k++)
+            {
+                FPRoomMetrics & m = out[k];
+                float area = 0.f, sum_x = 0.f, sum_y = 0.f, perimeter = 0.f;
+                for(; ring < s.room_end[k]; ring++)
+                {
+                    float a = 0.f, rx = 0.f, ry = 0.f;
+                    for(; e < s.ring_end[ring]; e++)
+                    {
+                        a += cross[e];
+                        rx += cx[e];
+                        ry += cy[e];
+                        perimeter += length[e];
+                    }
+                    if(a == 0.f)
+                        continue;
+                    float w = 0.5f * std::abs(a);
+                    area += w;
+                    sum_x += w * rx / (3.f * a);
+                    sum_y += w * ry / (3.f * a);
+                }
+                m.area = area;
+                m.perimeter = perimeter;
+                m.centroid = area > 0.f ? Vec2f(sum_x / area, sum_y / area) : Vec2f(0.f, 0.f);
+            }
+        }
+
+        void opening_metrics(const FloorPlan & plan, std::vector<FPRoomMetrics> & metrics)
+        {
+            auto r_count = int32_t(metrics.size());
+            auto add = [&](int32_t room, const FPOpening & o)
+            {
+                if(room < 0 || room >= r_count)
+                    return;
+                FPRoomMetrics & m = metrics[room];
+                if(o.type == EOpeningType::Door)
+                {
+                    m.door_count++;
+                }
+                else if(o.type == EOpeningType::Window)
+                {
+                    const Vec3f & half = o.bounding.xyz;
+                    float width = 2.f * std::max(std::abs(half.x()), std::abs(half.y()));
+                    float height = 2.f * std::abs(half.z());
+                    m.window_count++;
+                    m.window_area += width * height;
+                }
+            };
+
+            for(auto & o : plan.openings)
+            {
+                add(o.connection.first, o);
+                if(!o.connection.out && o.connection.second != o.connection.first)
+                    add(o.connection.second, o);
+            }
+
+            for(auto & m : metrics)
+                m.window_to_floor = m.area > 0.f ? m.window_area / m.area : 0.f;
+        }
+    }
+
+    void compute_room_metrics(const FloorPlan & plan, std::vector<FPRoomMetrics> & metrics, bool parallel)
+    {
+        metrics.assign(plan.rooms.size(), FPRoomMetrics());
+
+        if(parallel)
+        {
+            parallel_for(plan.rooms.size(), [&](size_t begin, size_t end, uint32_t)
+            {
+                MetricsScratch scratch;
+                room_geometry_metrics(plan, begin, end, metrics.data() + begin, scratch);
+            }, 4096);
+        }
+        else if(!plan.rooms.empty())
+        {
+            MetricsScratch scratch;
+            room_geometry_metrics(plan, 0, plan.rooms.size(), metrics.data(), scratch);
+        }
+
+        opening_metrics(plan, metrics);
+    }
+
+    const std::vector<FPRoomMetrics> & get_room_metrics(FloorPlan & plan)
+    {
+        auto & data = plan.data;
+        if(!data.metrics_valid || data.room_metrics.size() != plan.rooms.size())
+        {
+            compute_room_metrics(plan, data.room_metrics);
+            data.metrics_valid = true;
+        }
+        return data.room_metrics;
+    }
+
+    void update_room_metrics(std::span<FloorPlan> plans)
+    {
+        parallel_for(plans.size(), [&](size_t begin, size_t end, uint32_t)
+        {
+            for(size_t i = begin; i < end; i++)
+            {
+                auto & data = plans[i].data;
+                if(data.metrics_valid && data.room_metrics.size() == plans[i].rooms.size())
+                    continue;
+                compute_room_metrics(plans[i], data.room_metrics, false);
+                data.metrics_valid = true;
+            }
+        }, 1);
+    }
+}
\ No newline at end of file
@@ -1,7 +1,19 @@
 #pragma once
+#include <span>
+#include <vector>
+
 #include "core/data.h"
 
 namespace lmcore
 {
-    
+    // area, perimeter, centroid, window to floor ratio and opening counts for every room.
+    // ring vertices are flattened into structure of arrays, per edge terms are computed 4 wide through core/simd.h
+    void compute_room_metrics(const FloorPlan & plan, std::vector<FPRoomMetrics> & metrics, bool parallel = true);
+
+    // cached in plan.data and only recomputed after invalidate_plan_data or a room count change.
+    // geometry edited without invalidate_plan_data returns the stale metrics
+    const std::vector<FPRoomMetrics> & get_room_metrics(FloorPlan & plan);
+
+    // refreshes the cached metrics of many plans, plans are processed in parallel
+    void update_room_metrics(std::span<FloorPlan> plans);
 }
\ No newline at end of file
@@ -0,0 +1,327 @@
+#include "core/raster.h"
+#include "core/utils.h"
+#include "core/parallel.h"
+#include "core/simd.h"
+
+#include <limits>
+
+namespace lmcore
+{
+    namespace
+    {
+        struct RasterTriangle
+        {
+            float x[3];
+            float y[3];
+            RGBA8 color;
+        };
+
+        struct PlanToPixel
+        {
+            float scale = 1.f;
+            float min_x = 0.f;
+            float max_y = 0.f;
+            float offset_x = 0.f;
+            float offset_y = 0.f;
+
+            Vec2f operator()(const Vec2f & p) const
+            {
+                return {offset_x + (p.x() - min_x) * scale, offset_y + (max_y - p.y()) * scale};
+            }
+        };
+
+        PlanToPixel fit_plan(const FloorPlan & plan, const RasterOptions & options)
+        {
+            Vec2f lo(std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+            Vec2f hi = -lo;
+            for(auto & room : plan.rooms)
+            {
+                for(auto & geo : room.geometries)
+                {
+                    for(auto & p : geo.points)
+                    {
+                        lo = lo.cwiseMin(to_xy(p));
+                        hi = hi.cwiseMax(to_xy(p));
+                    }
+                }
+            }
+            for(auto & o : plan.openings)
+            {
+                Vec2f half = Vec2f(o.bounding.xyz.x(), o.bounding.xyz.y()).cwiseAbs();
+                lo = lo.cwiseMin(to_xy(o.position) - half);
+                hi = hi.cwiseMax(to_xy(o.position) + half);
+            }
+
+            PlanToPixel t;
+            if(lo.x() > hi.x())
+                return t;
+
+            Vec2f size = (hi - lo).cwiseMax(Vec2f(1e-3f, 1e-3f));
+            float avail_w = std::max(float(options.width) - 2.f * options.margin, 1.f);
+            float avail_h = std::max(float(options.height) - 2.f * options.margin, 1.f);
+            t.scale = std::min(avail_w / size.x(), avail_h / size.y());
+            t.min_x = lo.x();
+            t.max_y = hi.y();
+            t.offset_x = 0.5f * (float(options.width) - size.x() * t.scale);
+            t.offset_y = 0.5f * (float(options.height) - size.y() * t.scale);
+            return t;
+        }
+
+        void push_triangle(std::vector<RasterTriangle> & tris, const Vec2f & a, const Vec2f & b, const Vec2f & c, RGBA8 color)
+        {
+            tris.push_back({{a.x(), b.x(), c.x()}, {a.y(), b.y(), c.y()}, color});
+        }
+
+        void push_quad(std::vector<RasterTriangle> & tris, const Vec2f & a, const Vec2f & b, const Vec2f & c, const Vec2f & d, RGBA8 color)
+        {
+            push_triangle(tris, a, b, c, color);
+            push_triangle(tris, a, c, d, color);
+        }
+
+        bool point_in_triangle(const Vec2f & p, const Vec2f & a, const Vec2f & b, const Vec2f & c)
+        {
+            return cross_xy(b - a, p - a) >= 0.f && cross_xy(c - b, p - b) >= 0.f && cross_xy(a - c, p - c) >= 0.f;
+        }
+
+        // ear clipping, falls back to a fan when the ring is not simple
+        void triangulate_ring(std::vector<Vec2f> ring, RGBA8 color, std::vector<RasterTriangle> & tris)
+        {
+            if(ring.size() < 3)
+                return;
+
+            float area = 0.f;
+            for(size_t i = 0; i < ring.size(); i++)
+                area += cross_xy(ring[i], ring[(i + 1) % ring.size()]);
+            if(area < 0.f)
+                std::reverse(ring.begin(), ring.end());
+
+            std::vector<uint32_t> idx(ring.size());
+            for(uint32_t i = 0; i < idx.size(); i++)
+                idx[i] = i;
+
+            size_t guard = idx.size() * idx.size();
+            size_t i = 0;
+            while(idx.size() > 3 && guard-- > 0)
+            {
+                size_t n = idx.size();
+                const Vec2f & a = ring[idx[(i + n - 1) % n]];
+                const Vec2f & b = ring[idx[i % n]];
+                const Vec2f & c = ring[idx[(i + 1) % n]];
+
+                bool ear = cross_xy(b - a, c - b) > 0.f;
+                for(size_t k = 0; ear && k < n; k++)
+                {
+                    const Vec2f & p = ring[idx[k]];
+                    if(&p == &a || &p == &b || &p == &c)
+                        continue;
+                    ear = !point_in_triangle(p, a, b, c);
+                }
+
+                if(ear)
+                {
+                    push_triangle(tris, a, b, c, color);
+                    idx.erase(idx.begin() + (i % n));
+                }
+                else
+                {
+                    i++;
+                }
+            }
+
+            for(size_t k = 1; k + 1 < idx.size(); k++)
+                push_triangle(tris, ring[idx[0]], ring[idx[k]], ring[idx[k + 1]], color);
+        }
+
+        std::vector<RasterTriangle> build_triangles(const FloorPlan & plan, const PlanToPixel & t, const RasterOptions & options)
+        {
+            std::vector<RasterTriangle> tris;
+            std::vector<Vec2f> ring;
+
+            for(auto & room : plan.rooms)
+            {
+                for(auto & geo : room.geometries)
+                {
+                    ring.clear();
+                    for(auto & p : geo.points)
+                        ring.push_back(t(to_xy(p)));
+                    triangulate_ring(ring, room_type_color(room.type), tris);
+                }
+            }
+
+            float hw = 0.5f * options.wall_width;
+            for(auto & room : plan.rooms)
+            {
+                for(auto & geo : room.geometries)
+                {
+                    auto n = geo.points.size();
+                    for(size_t i = 0; n > 1 && i < n; i++)
+                    {
+                        Vec2f p0 = t(to_xy(geo.points[i]));
+                        Vec2f p1 = t(to_xy(geo.points[(i + 1) % n]));
+                        Vec2f d = p1 - p0;
+                        float l = d.norm();
+                        if(l <= 0.f)
+                            continue;
+                        d *= hw / l;
+                        Vec2f nrm(-d.y(), d.x());
+                        // extended by half the width so corners close
+                        push_quad(tris, p0 - d - nrm, p1 + d - nrm, p1 + d + nrm, p0 - d + nrm, options.wall_color);
+                    }
+                }
+            }
+
+            float ho = 0.5f * options.min_opening_width;
+            for(auto & o : plan.openings)
+            {
+                Vec2f c = t(to_xy(o.position));
+                Vec2f h = Vec2f(o.bounding.xyz.x(), o.bounding.xyz.y()).cwiseAbs() * t.scale;
+                h = h.cwiseMax(Vec2f(ho, ho));
+                RGBA8 color = o.type == EOpeningType::Window ? options.window_color : options.door_color;
+                push_quad(tris, {c.x() - h.x(), c.y() - h.y()}, {c.x() + h.x(), c.y() - h.y()},
+                    {c.x() + h.x(), c.y() + h.y()}, {c.x() - h.x(), c.y() + h.y()}, color);
+            }
+
+            return tris;
+        }
+
+        struct TileRect
+        {
+            int32_t x0, y0, x1, y1;
+        };
+
+        void raster_triangle(const RasterTriangle & tri, const TileRect & tile, RasterImage & image)
+        {
+            float x0 = tri.x[0], y0 = tri.y[0];
+            float x1 = tri.x[1], y1 = tri.y[1];
+            float x2 = tri.x[2], y2 = tri.y[2];
+
+            float area = (x1 - x0) * (y2 - y0) - (y1 - y0) * (x2 - x0);
+            if(std::abs(area) < 1e-8f)
+                return;
+            if(area < 0.f)
+            {
+                std::swap(x1, x2);
+                std::swap(y1, y2);
+            }
+
+            int32_t bx0 = std::max(tile.x0, int32_t(std::floor(std::min({x0, x1, x2}))));
+            int32_t by0 = std::max(tile.y0, int32_t(std::floor(std::min({y0, y1, y2}))));
+            int32_t bx1 = std::min(tile.x1, int32_t(std::ceil(std::max({x0, x1, x2}))) + 1);
+            int32_t by1 = std::min(tile.y1, int32_t(std::ceil(std::max({y0, y1, y2}))) + 1);
+            if(bx0 >= bx1 || by0 >= by1)
+                return;
+
+            // E(p) = a * p.x + b * p.y + c, inside where all three are >= 0
+            float ea[3], eb[3], ec[3];
+            const float vx[3] = {x0, x1, x2};
+            const float vy[3] = {y0, y1, y2};
+            for(int e = 0; e < 3; e++)
+            {
+                int n = (e + 1) % 3;
+                ea[e] = -(vy[n] - vy[e]);
+                eb[e] = vx[n] - vx[e];
+                ec[e] = -(ea[e] * vx[e] + eb[e] * vy[e]);
+            }
+
+            const f32x4 lane = f32x4::set(0.5f, 1.5f, 2.5f, 3.5f);
+            const f32x4 zero = f32x4::splat(0.f);
+            const f32x4 a0 = f32x4::splat(ea[0]), a1 = f32x4::splat(ea[1]), a2 = f32x4::splat(ea[2]);
+            const f32x4 xend = f32x4::splat(float(bx1));
+
+            for(int32_t y = by0; y < by1; y++)
+            {
+                float py = float(y) + 0.5f;
+                f32x4 r0 = f32x4::splat(eb[0] * py + ec[0]);
+                f32x4 r1 = f32x4::splat(eb[1] * py + ec[1]);
+                f32x4 r2 = f32x4::splat(eb[2] * py + ec[2]);
+                RGBA8 * row = image.pixels.data() + size_t(y) * image.width;
+
+                for(int32_t x = bx0; x < bx1; x += 4)
+                {
+                    f32x4 px = f32x4::splat(float(x)) + lane;
+                    f32x4 inside = mask_and(cmpge(a0 * px + r0, zero), cmpge(a1 * px + r1, zero));
+                    inside = mask_and(inside, cmpge(a2 * px + r2, zero));
+                    inside = mask_and(inside, cmplt(px, xend));
+
+                    int bits = movemask(inside);
+                    if(bits == 0)
+                        continue;
+                    if(bits == 0xf)
+                    {
+                        row[x] = row[x + 1] = row[x + 2] = row[x + 3] = tri.color;
+                        continue;
+                    }
+                    for(int k = 0; k < 4; k++)
+                    {
+                        if(bits & (1 << k))
+                            row[x + k] = tri.color;
+                    }
+                }
+            }
+        }
+    }
+
+    RGBA8 room_type_color(ERoomType type)
+    {
+        switch(type)
+        {
+            case ERoomType::LivingRoom: return make_rgba8(232, 201, 155);
+            case ERoomType::Bedroom:    return make_rgba8(155, 193, 232);
+            case ERoomType::DiningRoom: return make_rgba8(232, 168, 155);
+            case ERoomType::Kitchen:    return make_rgba8(181, 224, 155);
+            case ERoomType::Bathroom:   return make_rgba8(155, 224, 216);
+            default:                    return make_rgba8(200, 200, 200);
+        }
+    }
+
+    RasterImage rasterize_floor_plan(const FloorPlan & plan, const RasterOptions & options)
+    {
+        RasterImage image;
+        image.width = options.width;
+        image.height = options.height;
+        image.pixels.assign(size_t(image.width) * image.height, options.background);
+        if(image.pixels.empty())
+            return image;
+
+        auto t = fit_plan(plan, options);
+        auto tris = build_triangles(plan, t, options);
+
+        const int32_t ts = int32_t(std::max<uint32_t>(options.tile_size, 4));
+        const int32_t tiles_x = (int32_t(image.width) + ts - 1) / ts;
+        const int32_t tiles_y = (int32_t(image.height) + ts - 1) / ts;
+
+        // bin in submission order so every tile keeps the painter's order
+        std::vector<std::vector<uint32_t>> bins(size_t(tiles_x) * tiles_y);
+        for(uint32_t i = 0; i < tris.size(); i++)
+        {
+            const auto & tri = tris[i];
+            float minx = std::min({tri.x[0], tri.x[1], tri.x[2]});
+            float maxx = std::max({tri.x[0], tri.x[1], tri.x[2]});
+            float miny = std::min({tri.y[0], tri.y[1], tri.y[2]});
+            float maxy = std::max({tri.y[0], tri.y[1], tri.y[2]});
+            int32_t tx0 = std::clamp(int32_t(std::floor(minx)) / ts, 0, tiles_x - 1);
+            int32_t tx1 = std::clamp(int32_t(std::ceil(maxx)) / ts, 0, tiles_x - 1);
+            int32_t ty0 = std::clamp(int32_t(std::floor(miny)) / ts, 0, tiles_y - 1);
+            int32_t ty1 = std::clamp(int32_t(std::ceil(maxy)) / ts, 0, tiles_y - 1);
+            if(maxx < 0.f || maxy < 0.f || minx >= float(image.width) || miny >= float(image.height))
+                continue;
+            for(int32_t ty = ty0; ty <= ty1; ty++)
+                for(int32_t tx = tx0; tx <= tx1; tx++)
+                    bins[size_t(ty) * tiles_x + tx].push_back(i);
+        }
+
+        parallel_for(bins.size(), [&](size_t begin, size_t end, uint32_t)
+        {
+            for(size_t b = begin; b < end; b++)
+            {
+                int32_t tx = int32_t(b % tiles_x);
+                int32_t ty = int32_t(b / tiles_x);
+                TileRect tile{tx * ts, ty * ts, std::min((tx + 1) * ts, int32_t(image.width)), std::min((ty + 1) * ts, int32_t(image.height))};
+                for(auto i : bins[b])
+                    raster_triangle(tris[i], tile, image);
+            }
+        }, 4);
+
+        return image;
+    }
+}
\ No newline at end of file
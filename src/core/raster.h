@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "core/data.h"
+
+namespace lmcore
+{
+    // 8 bit rgba packed little endian, r in the lowest byte
+    typedef uint32_t RGBA8;
+
+    constexpr RGBA8 make_rgba8(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255)
+    {
+        return RGBA8(r) | (RGBA8(g) << 8) | (RGBA8(b) << 16) | (RGBA8(a) << 24);
+    }
+
+    struct RasterImage
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<RGBA8> pixels;
+
+        const uint8_t * data() const { return reinterpret_cast<const uint8_t *>(pixels.data()); }
+    };
+
+    struct RasterOptions
+    {
+        uint32_t width = 512;
+        uint32_t height = 512;
+        uint32_t tile_size = 64;
+        // border around the plan in pixels
+        float margin = 16.f;
+        float wall_width = 2.f;
+        // openings thinner than this (windows are often zero thick) are widened to it, in pixels
+        float min_opening_width = 3.f;
+
+        RGBA8 background = make_rgba8(255, 255, 255);
+        RGBA8 wall_color = make_rgba8(48, 48, 48);
+        RGBA8 door_color = make_rgba8(192, 96, 32);
+        RGBA8 window_color = make_rgba8(64, 144, 240);
+    };
+
+    RGBA8 room_type_color(ERoomType type);
+
+    // top down map of the plan: room fills by type, walls along every ring edge, then opening markers.
+    // triangles are binned into tiles and tiles are rasterized in parallel with 4 wide edge functions
+    RasterImage rasterize_floor_plan(const FloorPlan & plan, const RasterOptions & options = {});
+}
\ No newline at end of file
@@ -0,0 +1,351 @@
+#include "core/raycast.h"
+#include "core/utils.h"
+#include "core/parallel.h"
+#include "core/simd.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace lmcore
+{
+    namespace
+    {
+        constexpr uint32_t k_leaf_size = 4;
+        constexpr uint32_t k_max_depth = 48;
+
+        struct Bounds
+        {
+            Vec2f lo = Vec2f(std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+            Vec2f hi = Vec2f(-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max());
+
+            void grow(const Vec2f & p)
+            {
+                lo = lo.cwiseMin(p);
+                hi = hi.cwiseMax(p);
+            }
+        };
+
+        // keeps the sign so 1/d stays finite and the slab test never sees 0 * inf
+        float safe_inverse(float d)
+        {
+            const float tiny = 1e-20f;
+            if(std::abs(d) < tiny)
+                d = std::copysign(tiny, d);
+            return 1.f / d;
+        }
+    }
+
+    std::vector<FPWallSegment> extract_wall_segments(const FloorPlan & plan, float wall_tolerance)
+    {
+        auto r_count = plan.rooms.size();
+
+        // openings of every room in one flat list
+        std::vector<uint32_t> first(r_count + 1, 0);
+        auto valid_room = [&](int32_t r) { return r >= 0 && size_t(r) < r_count; };
+        for(auto & o : plan.openings)
+        {
+            if(valid_room(o.connection.first))
+                first[o.connection.first + 1]++;
+            if(!o.connection.out && valid_room(o.connection.second) && o.connection.second != o.connection.first)
+                first[o.connection.second + 1]++;
+        }
+        for(size_t r = 0; r < r_count; r++)
+            first[r + 1] += first[r];
+        std::vector<uint32_t> room_openings(first[r_count]);
+        std::vector<uint32_t> fill(first.begin(), first.end() - 1);
+        for(uint32_t i = 0; i < plan.openings.size(); i++)
+        {
+            const auto & c = plan.openings[i].connection;
+            if(valid_room(c.first))
+                room_openings[fill[c.first]++] = i;
+            if(!c.out && valid_room(c.second) && c.second != c.first)
+                room_openings[fill[c.second]++] = i;
+        }
+
+        std::vector<FPWallSegment> segments;
+        std::vector<std::pair<float, float>> cuts;
+        for(size_t r = 0; r < r_count; r++)
+        {
+            for(auto & geo : plan.rooms[r].geometries)
+            {
+                auto n = geo.points.size();
+                for(size_t i = 0; n > 1 && i < n; i++)
+                {
+                    Vec2f p0 = to_xy(geo.points[i]);
+                    Vec2f p1 = to_xy(geo.points[(i + 1) % n]);
+                    float len = (p1 - p0).norm();
+                    if(len <= 0.f)
+                        continue;
+                    Vec2f dir = (p1 - p0) / len;
+
+                    cuts.clear();
+                    for(uint32_t k = first[r]; k < first[r + 1]; k++)
+                    {
+                        const auto & o = plan.openings[room_openings[k]];
+                        Vec2f c = to_xy(o.position);
+                        float hx = std::abs(o.bounding.xyz.x());
+                        float hy = std::abs(o.bounding.xyz.y());
+                        if(point_segment_distance_xy(p0, p1, c) > std::min(hx, hy) + wall_tolerance)
+                            continue;
+                        float s = (c - p0).dot(dir);
+                        float half_width = std::max(hx, hy);
+                        cuts.push_back({s - half_width, s + half_width});
+                    }
+                    std::sort(cuts.begin(), cuts.end());
+
+                    float cur = 0.f;
+                    auto emit = [&](float a, float b)
+                    {
+                        if(b - a > 1e-5f)
+                            segments.push_back({p0 + a * dir, p0 + b * dir, int32_t(r)});
+                    };
+                    for(auto & cut : cuts)
+                    {
+                        if(cut.first > cur)
+                            emit(cur, std::min(cut.first, len));
+                        cur = std::max(cur, cut.second);
+                        if(cur >= len)
+                            break;
+                    }
+                    if(cur < len)
+                        emit(cur, len);
+                }
+            }
+        }
+        return segments;
+    }
+
+    void RayScene::build(const FloorPlan & plan, float wall_tolerance)
+    {
+        build(extract_wall_segments(plan, wall_tolerance));
+    }
+
+    void RayScene::build(std::vector<FPWallSegment> walls)
+    {
+        segments = std::move(walls);
+        nodes.clear();
+        sx.clear(); sy.clear(); sdx.clear(); sdy.clear();
+        ids.clear();
+        if(segments.empty())
+            return;
+
+        std::vector<uint32_t> order(segments.size());
+        for(uint32_t i = 0; i < order.size(); i++)
+            order[i] = i;
+
+        nodes.reserve(2 * segments.size() / k_leaf_size + 1);
+        build_node(order, 0, uint32_t(order.size()), 0);
+
+        auto s_count = order.size();
+        sx.resize(s_count); sy.resize(s_count); sdx.resize(s_count); sdy.resize(s_count);
+        ids.resize(s_count);
+        for(size_t i = 0; i < s_count; i++)
+        {
+            const auto & s = segments[order[i]];
+            sx[i] = s.start.x();
+            sy[i] = s.start.y();
+            sdx[i] = s.end.x() - s.start.x();
+            sdy[i] = s.end.y() - s.start.y();
+            ids[i] = int32_t(order[i]);
+        }
+    }
+
+    uint32_t RayScene::build_node(std::vector<uint32_t> & order, uint32_t begin, uint32_t end, uint32_t depth)
+    {
+        Bounds box, centers;
+        for(uint32_t i = begin; i < end; i++)
+        {
+            const auto & s = segments[order[i]];
+            box.grow(s.start);
+            box.grow(s.end);
+            centers.grow(0.5f * (s.start + s.end));
+        }
+
+        uint32_t index = uint32_t(nodes.size());
+        nodes.push_back({});
+        Node & node = nodes.back();
+        node.bmin[0] = box.lo.x();
+        node.bmin[1] = box.lo.y();
+        node.bmax[0] = box.hi.x();
+        node.bmax[1] = box.hi.y();
+
+        uint32_t count = end - begin;
+        if(count <= k_leaf_size || depth >= k_max_depth)
+        {
+            node.offset = begin;
+            node.count = uint16_t(count);
+            node.axis = 0;
+            return index;
+        }
+
+        // median split on the longest axis of the segment centers
+        Vec2f extent = centers.hi - centers.lo;
+        uint16_t axis = extent.y() > extent.x() ? 1 : 0;
+        uint32_t mid = begin + count / 2;
+        std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end, [&](uint32_t a, uint32_t b)
+        {
+            const auto & sa = segments[a];
+            const auto & sb = segments[b];
+            return sa.start[axis] + sa.end[axis] < sb.start[axis] + sb.end[axis];
+        });
+
+        nodes[index].axis = axis;
+        nodes[index].count = 0;
+        build_node(order, begin, mid, depth + 1);
+        uint32_t right = build_node(order, mid, end, depth + 1);
+        nodes[index].offset = right;
+        return index;
+    }
+
+    void RayScene::cast_packet(const PLine * rays, uint32_t count, float max_t, FPRayHit * hits) const
+    {
+        count = std::min(count, k_packet_size);
+
+        alignas(16) float ox[4], oy[4], dx[4], dy[4], ix[4], iy[4], tm[4];
+        int32_t best[4] = {-1, -1, -1, -1};
+        for(uint32_t k = 0; k < 4; k++)
+        {
+            bool active = k < count;
+            ox[k] = active ? rays[k].origin().x() : 0.f;
+            oy[k] = active ? rays[k].origin().y() : 0.f;
+            dx[k] = active ? rays[k].direction().x() : 1.f;
+            dy[k] = active ? rays[k].direction().y() : 0.f;
+            ix[k] = safe_inverse(dx[k]);
+            iy[k] = safe_inverse(dy[k]);
+            // inactive lanes get a negative range and never hit anything
+            tm[k] = active ? max_t : -1.f;
+        }
+
+        if(!nodes.empty())
+        {
+            const f32x4 vox = f32x4::load(ox), voy = f32x4::load(oy);
+            const f32x4 vdx = f32x4::load(dx), vdy = f32x4::load(dy);
+            const f32x4 vix = f32x4::load(ix), viy = f32x4::load(iy);
+            const f32x4 zero = f32x4::splat(0.f);
+            const f32x4 one = f32x4::splat(1.f);
+            const f32x4 eps = f32x4::splat(1e-12f);
+            f32x4 vtm = f32x4::load(tm);
+
+            uint32_t stack[2 * k_max_depth + 2];
+            uint32_t sp = 0;
+            uint32_t current = 0;
+            while(true)
+            {
+                const Node & n = nodes[current];
+
+                f32x4 t1 = (f32x4::splat(n.bmin[0]) - vox) * vix;
+                f32x4 t2 = (f32x4::splat(n.bmax[0]) - vox) * vix;
+                f32x4 t3 = (f32x4::splat(n.bmin[1]) - voy) * viy;
+                f32x4 t4 = (f32x4::splat(n.bmax[1]) - voy) * viy;
+                f32x4 tnear = max(max(min(t1, t2), min(t3, t4)), zero);
+                f32x4 tfar = min(min(max(t1, t2), max(t3, t4)), vtm);
+
+                if(movemask(cmpge(tfar, tnear)) != 0)
+                {
+                    if(n.count > 0)
+                    {
+                        for(uint32_t i = n.offset; i < n.offset + n.count; i++)
+                        {
+                            f32x4 ex = f32x4::splat(sdx[i]);
+                            f32x4 ey = f32x4::splat(sdy[i]);
+                            f32x4 wx = f32x4::splat(sx[i]) - vox;
+                            f32x4 wy = f32x4::splat(sy[i]) - voy;
+                            f32x4 denom = vdx * ey - vdy * ex;
+                            f32x4 t = (wx * ey - wy * ex) / denom;
+                            f32x4 u = (wx * vdy - wy * vdx) / denom;
+
+                            f32x4 hit = mask_and(cmplt(eps, denom * denom), cmpge(t, zero));
+                            hit = mask_and(hit, cmplt(t, vtm));
+                            hit = mask_and(hit, mask_and(cmpge(u, zero), cmpge(one, u)));
+
+                            int bits = movemask(hit);
+                            if(bits == 0)
+                                continue;
+                            vtm = select(hit, t, vtm);
+                            for(int k = 0; k < 4; k++)
+                            {
+                                if(bits & (1 << k))
+                                    best[k] = ids[i];
+                            }
+                        }
+                    }
+                    else
+                    {
+                        // front to back along the first ray on the split axis
+                        uint32_t near_child = current + 1;
+                        uint32_t far_child = n.offset;
+                        if((n.axis == 0 ? dx[0] : dy[0]) < 0.f)
+                            std::swap(near_child, far_child);
+                        stack[sp++] = far_child;
+                        current = near_child;
+                        continue;
+                    }
+                }
+
+                if(sp == 0)
+                    break;
+                current = stack[--sp];
+            }
+
+            vtm.store(tm);
+        }
+
+        for(uint32_t k = 0; k < count; k++)
+        {
+            hits[k].segment = best[k];
+            hits[k].t = best[k] >= 0 ? tm[k] : max_t;
+        }
+    }
+
+    FPRayHit RayScene::cast(const PLine & ray, float max_t) const
+    {
+        FPRayHit hit;
+        cast_packet(&ray, 1, max_t, &hit);
+        return hit;
+    }
+
+    void RayScene::cast_batch(std::span<const PLine> rays, float max_t, std::span<FPRayHit> hits) const
+    {
+        size_t count = std::min(rays.size(), hits.size());
+        size_t packets = (count + k_packet_size - 1) / k_packet_size;
+        parallel_for(packets, [&](size_t begin, size_t end, uint32_t)
+        {
+            for(size_t p = begin; p < end; p++)
+            {
+                size_t first = p * k_packet_size;
+                uint32_t n = uint32_t(std::min<size_t>(k_packet_size, count - first));
+                cast_packet(rays.data() + first, n, max_t, hits.data() + first);
+            }
+        }, 256);
+    }
+
+    bool RayScene::is_visible(const Vec2f & from, const Vec2f & to) const
+    {
+        Vec2f d = to - from;
+        float dist = d.norm();
+        if(dist <= 0.f)
+            return true;
+        // a target lying on a wall still counts as visible
+        return !cast(PLine(from, d / dist), dist * (1.f - 1e-4f)).hit();
+    }
+
+    std::vector<Vec2f> RayScene::isovist(const Vec2f & origin, uint32_t ray_count, float max_distance) const
+    {
+        std::vector<PLine> rays;
+        rays.reserve(ray_count);
+        const float step = 2.f * float(EIGEN_PI) / float(std::max(ray_count, 1u));
+        for(uint32_t i = 0; i < ray_count; i++)
+        {
+            float a = step * float(i);
+            rays.emplace_back(origin, Vec2f(std::cos(a), std::sin(a)));
+        }
+
+        std::vector<FPRayHit> hits(ray_count);
+        cast_batch(rays, max_distance, hits);
+
+        std::vector<Vec2f> polygon(ray_count);
+        for(uint32_t i = 0; i < ray_count; i++)
+            polygon[i] = origin + rays[i].direction() * hits[i].t;
+        return polygon;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "core/data.h"
+
+namespace lmcore
+{
+    struct FPWallSegment
+    {
+        Vec2f start = {0.f, 0.f};
+        Vec2f end = {0.f, 0.f};
+        int32_t room = -1;
+    };
+
+    struct FPRayHit
+    {
+        float t = std::numeric_limits<float>::max();
+        int32_t segment = -1;
+
+        bool hit() const { return segment >= 0; }
+    };
+
+    // every room ring edge as a wall segment, with the span covered by a connected opening cut out
+    // so doors and windows are transparent to rays
+    std::vector<FPWallSegment> extract_wall_segments(const FloorPlan & plan, float wall_tolerance = 0.05f);
+
+    // 2d ray casting over wall segments. the bvh is flattened depth first and traversed by packets
+    // of 4 rays at once, box and segment tests run 4 wide through core/simd.h
+    class RayScene
+    {
+    public:
+        static constexpr uint32_t k_packet_size = 4;
+
+        void build(const FloorPlan & plan, float wall_tolerance = 0.05f);
+        void build(std::vector<FPWallSegment> segments);
+
+        // ray directions are expected normalized so t is a distance
+        FPRayHit cast(const PLine & ray, float max_t = std::numeric_limits<float>::max()) const;
+        void cast_packet(const PLine * rays, uint32_t count, float max_t, FPRayHit * hits) const;
+        // splits the batch into packets and processes them across threads
+        void cast_batch(std::span<const PLine> rays, float max_t, std::span<FPRayHit> hits) const;
+
+        bool is_visible(const Vec2f & from, const Vec2f & to) const;
+        // polygon of everything visible from origin, one vertex per ray, clipped at max_distance
+        std::vector<Vec2f> isovist(const Vec2f & origin, uint32_t ray_count, float max_distance) const;
+
+        const std::vector<FPWallSegment> & get_segments() const { return segments; }
+
+    private:
+        struct Node
+        {
+            float bmin[2];
+            float bmax[2];
+            // interior: right child, the left child follows the node. leaf: first segment
+            uint32_t offset;
+            uint16_t count;
+            uint16_t axis;
+        };
+
+        uint32_t build_node(std::vector<uint32_t> & order, uint32_t begin, uint32_t end, uint32_t depth);
+
+        std::vector<FPWallSegment> segments;
+        std::vector<Node> nodes;
+        // segments in leaf order as structure of arrays, start point and start to end delta
+        std::vector<float> sx, sy, sdx, sdy;
+        std::vector<int32_t> ids;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,102 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define LMCORE_SIMD_SSE2 1
+    #include <emmintrin.h>
+#endif
+
+namespace lmcore
+{
+    // 4 wide float vector, SSE2 when available and a plain array otherwise
+    struct f32x4
+    {
+#ifdef LMCORE_SIMD_SSE2
+        __m128 v;
+
+        static f32x4 splat(float a) { return {_mm_set1_ps(a)}; }
+        static f32x4 set(float a, float b, float c, float d) { return {_mm_setr_ps(a, b, c, d)}; }
+        static f32x4 load(const float * p) { return {_mm_loadu_ps(p)}; }
+        void store(float * p) const { _mm_storeu_ps(p, v); }
+#else
+        float v[4];
+
+        static f32x4 splat(float a) { return {{a, a, a, a}}; }
+        static f32x4 set(float a, float b, float c, float d) { return {{a, b, c, d}}; }
+        static f32x4 load(const float * p) { return {{p[0], p[1], p[2], p[3]}}; }
+        void store(float * p) const { for(int i = 0; i < 4; i++) p[i] = v[i]; }
+#endif
+    };
+
+#ifdef LMCORE_SIMD_SSE2
+    inline f32x4 operator+(f32x4 a, f32x4 b) { return {_mm_add_ps(a.v, b.v)}; }
+    inline f32x4 operator-(f32x4 a, f32x4 b) { return {_mm_sub_ps(a.v, b.v)}; }
+    inline f32x4 operator*(f32x4 a, f32x4 b) { return {_mm_mul_ps(a.v, b.v)}; }
+    inline f32x4 operator/(f32x4 a, f32x4 b) { return {_mm_div_ps(a.v, b.v)}; }
+    inline f32x4 min(f32x4 a, f32x4 b) { return {_mm_min_ps(a.v, b.v)}; }
+    inline f32x4 max(f32x4 a, f32x4 b) { return {_mm_max_ps(a.v, b.v)}; }
+    inline f32x4 sqrt(f32x4 a) { return {_mm_sqrt_ps(a.v)}; }
+    // comparisons return a lane mask, consumed with mask_and/mask_or/movemask
+    inline f32x4 cmpge(f32x4 a, f32x4 b) { return {_mm_cmpge_ps(a.v, b.v)}; }
+    inline f32x4 cmplt(f32x4 a, f32x4 b) { return {_mm_cmplt_ps(a.v, b.v)}; }
+    inline f32x4 mask_and(f32x4 a, f32x4 b) { return {_mm_and_ps(a.v, b.v)}; }
+    inline f32x4 mask_or(f32x4 a, f32x4 b) { return {_mm_or_ps(a.v, b.v)}; }
+    inline f32x4 select(f32x4 mask, f32x4 a, f32x4 b) { return {_mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v))}; }
+    inline int movemask(f32x4 mask) { return _mm_movemask_ps(mask.v); }
+#else
+    namespace detail
+    {
+        template<typename F>
+        inline f32x4 map(f32x4 a, f32x4 b, F && f)
+        {
+            f32x4 r;
+            for(int i = 0; i < 4; i++)
+                r.v[i] = f(a.v[i], b.v[i]);
+            return r;
+        }
+
+        inline float mask_bits(bool b)
+        {
+            uint32_t u = b ? 0xffffffffu : 0u;
+            float f;
+            std::copy_n(reinterpret_cast<const char *>(&u), 4, reinterpret_cast<char *>(&f));
+            return f;
+        }
+
+        inline bool mask_set(float f)
+        {
+            uint32_t u;
+            std::copy_n(reinterpret_cast<const char *>(&f), 4, reinterpret_cast<char *>(&u));
+            return u != 0;
+        }
+    }
+
+    inline f32x4 operator+(f32x4 a, f32x4 b) { return detail::map(a, b, [](float x, float y) { return x + y; }); }
+    inline f32x4 operator-(f32x4 a, f32x4 b) { return detail::map(a, b, [](float x, float y) { return x - y; }); }
+    inline f32x4 operator*(f32x4 a, f32x4 b) { return detail::map(a, b, [](float x, float y) { return x * y; }); }
+    inline f32x4 operator/(f32x4 a, f32x4 b) { return detail::map(a, b, [](float x, float y) { return x / y; }); }
+    inline f32x4 min(f32x4 a, f32x4 b) { return detail::map(a, b, [](float x, float y) { return std::min(x, y); }); }
+    inline f32x4 max(f32x4 a, f32x4 b) { return detail::map(a, b, [](float x, float y) { return std::max(x, y); }); }
+    inline f32x4 sqrt(f32x4 a) { return detail::map(a, a, [](float x, float) { return std::sqrt(x); }); }
+    inline f32x4 cmpge(f32x4 a, f32x4 b) { return detail::map(a, b, [](float x, float y) { return detail::mask_bits(x >= y); }); }
+    inline f32x4 cmplt(f32x4 a, f32x4 b) { return detail::map(a, b, [](float x, float y) { return detail::mask_bits(x < y); }); }
+    inline f32x4 mask_and(f32x4 a, f32x4 b) { return detail::map(a, b, [](float x, float y) { return detail::mask_bits(detail::mask_set(x) && detail::mask_set(y)); }); }
+    inline f32x4 mask_or(f32x4 a, f32x4 b) { return detail::map(a, b, [](float x, float y) { return detail::mask_bits(detail::mask_set(x) || detail::mask_set(y)); }); }
+    inline f32x4 select(f32x4 mask, f32x4 a, f32x4 b)
+    {
+        f32x4 r;
+        for(int i = 0; i < 4; i++)
+            r.v[i] = detail::mask_set(mask.v[i]) ? a.v[i] : b.v[i];
+        return r;
+    }
+    inline int movemask(f32x4 mask)
+    {
+        int m = 0;
+        for(int i = 0; i < 4; i++)
+            m |= detail::mask_set(mask.v[i]) ? (1 << i) : 0;
+        return m;
+    }
+#endif
+}
\ No newline at end of file
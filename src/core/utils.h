@@ -3,15 +3,28 @@
 #include "core/data.h"
 #include "Eigen/Geometry"
 
+#include <algorithm>
+#include <cmath>
+
 namespace lmcore{
-    Vec3f get_line_direction(const FPLineSegment & line)
+    inline Vec3f get_line_direction(const FPLineSegment & line)
     {
         Vec3f dir = line.start.value - line.end.value;
         return dir;
     }
 
+    inline float cross_xy(const Vec2f & a, const Vec2f & b)
+    {
+        return a.x() * b.y() - a.y() * b.x();
+    }
+
+    inline Vec2f to_xy(const FPPoint & p)
+    {
+        return {p.value.x(), p.value.y()};
+    }
+
     // Function to find the intersection point if it exists
-    bool is_point_on_segment(const Vec2f & p0,const Vec2f p1, const Vec2f & pi)
+    inline bool is_point_on_segment(const Vec2f & p0,const Vec2f p1, const Vec2f & pi)
     {
         PLine _pfirst = PLine::Through(p0,p1);
         float _sqrl_first = (p1-p0).squaredNorm();
@@ -23,34 +36,78 @@ namespace lmcore{
         return _is_on_first;
     }
 
-    bool find_segment_intersection_xy(const FPLineSegment & first, const FPLineSegment & second, FPPoint& intersectionPoint) {
-        Vec2f p0 = {first.start.value.x(),first.start.value.y()};
-        Vec2f p1 = {first.end.value.x(),first.end.value.y()};
-        Vec2f q0 = {second.start.value.x(),second.start.value.y()};
-        Vec2f q1 = {second.end.value.x(),second.end.value.y()};
+    inline float point_segment_distance_xy(const Vec2f & p0, const Vec2f & p1, const Vec2f & p)
+    {
+        Vec2f d = p1 - p0;
+        float l2 = d.squaredNorm();
+        if(l2 <= 0.f)
+            return (p - p0).norm();
+        float t = std::clamp((p - p0).dot(d) / l2, 0.f, 1.f);
+        return (p - (p0 + t * d)).norm();
+    }
 
-        Line _first = Line::Through(p0,p1);
-        Line _second = Line::Through(q0,q1);
-        Vec2f _prob_is = _first.intersection(_second);
+    inline bool find_segment_intersection_xy(const Vec2f & p0, const Vec2f & p1, const Vec2f & q0, const Vec2f & q1, Vec2f & intersection, float eps = 1e-6f)
+    {
+        // cheap reject on the bounding boxes first, most pairs never get further
+        if(std::max(p0.x(), p1.x()) + eps < std::min(q0.x(), q1.x()) ||
+           std::max(q0.x(), q1.x()) + eps < std::min(p0.x(), p1.x()) ||
+           std::max(p0.y(), p1.y()) + eps < std::min(q0.y(), q1.y()) ||
+           std::max(q0.y(), q1.y()) + eps < std::min(p0.y(), p1.y()))
+            return false;
 
-        bool on_first = is_point_on_segment(p0,p1,_prob_is);
-        bool on_second = is_point_on_segment(q0,q1,_prob_is);
-        bool is_parallel = (p1-p0).dot(q0-q1);
+        Vec2f r = p1 - p0;
+        Vec2f s = q1 - q0;
+        Vec2f qp = q0 - p0;
+        float denom = cross_xy(r, s);
+        float rl = r.norm();
+        float sl = s.norm();
 
-        if(on_first && on_second && !is_parallel)
+        if(std::abs(denom) <= eps * std::max(rl * sl, 1.f))
         {
-            // there is one intersec
+            // parallel, only collinear segments can overlap
+            if(std::abs(cross_xy(qp, r)) > eps * std::max(rl, 1.f))
+                return false;
+
+            float rr = r.squaredNorm();
+            if(rr <= 0.f)
+            {
+                if(point_segment_distance_xy(q0, q1, p0) > eps)
+                    return false;
+                intersection = p0;
+                return true;
+            }
+
+            float t0 = qp.dot(r) / rr;
+            float t1 = t0 + s.dot(r) / rr;
+            if(t0 > t1)
+                std::swap(t0, t1);
+            if(t1 < -eps || t0 > 1.f + eps)
+                return false;
+
+            // overlap, report the first shared point along the first segment
+            intersection = p0 + std::max(t0, 0.f) * r;
             return true;
         }
 
-        if(on_first && on_second && is_parallel)
+        float t = cross_xy(qp, s) / denom;
+        float u = cross_xy(qp, r) / denom;
+        if(t < -eps || t > 1.f + eps || u < -eps || u > 1.f + eps)
+            return false;
+
+        intersection = p0 + t * r;
+        return true;
+    }
+
+    inline bool find_segment_intersection_xy(const FPLineSegment & first, const FPLineSegment & second, FPPoint& intersectionPoint) {
+        Vec2f is;
+        if(!find_segment_intersection_xy(to_xy(first.start), to_xy(first.end), to_xy(second.start), to_xy(second.end), is))
         {
-            // overlap
-            return true;
+            //there is no intersec
+            return false;
         }
 
-        //there is no intersec
-        return false;
+        intersectionPoint.value = {is.x(), is.y(), 0.f};
+        return true;
     }
 
     // std::vector<lmcore::FPLineSegment> intersect_lines(const FPLineSegment & first, const FPLineSegment & second)
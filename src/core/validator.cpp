@@ -0,0 +1,347 @@
+#include "core/validator.h"
+#include "core/utils.h"
+#include "core/parallel.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace lmcore
+{
+    namespace
+    {
+        struct RingVertex
+        {
+            Vec2f xy;
+            float z;
+        };
+
+        float snap_value(float v, float tolerance)
+        {
+            if(tolerance <= 0.f)
+                return v;
+            return std::round(v / tolerance) * tolerance;
+        }
+
+        float ring_signed_area(const std::vector<RingVertex> & ring)
+        {
+            float a = 0.f;
+            auto n = ring.size();
+            for(size_t i = 0; i < n; i++)
+                a += cross_xy(ring[i].xy, ring[(i + 1) % n].xy);
+            return 0.5f * a;
+        }
+
+        bool ring_self_intersects(const std::vector<RingVertex> & ring)
+        {
+            auto n = ring.size();
+            if(n < 4)
+                return false;
+
+            Vec2f is;
+            for(size_t i = 0; i < n; i++)
+            {
+                const Vec2f & p0 = ring[i].xy;
+                const Vec2f & p1 = ring[(i + 1) % n].xy;
+                // edges sharing a vertex with edge i are skipped, they always touch
+                for(size_t j = i + 2; j < n; j++)
+                {
+                    if(i == 0 && j == n - 1)
+                        continue;
+                    if(find_segment_intersection_xy(p0, p1, ring[j].xy, ring[(j + 1) % n].xy, is))
+                        return true;
+                }
+            }
+            return false;
+        }
+
+        bool same_vertex(const RingVertex & a, const RingVertex & b, float tolerance)
+        {
+            return (a.xy - b.xy).cwiseAbs().maxCoeff() <= tolerance;
+        }
+
+        // the same cyclic vertex sequence in either winding, starting anywhere. comparing point sets
+        // would also match different rings over the same vertices, e.g. two orderings of a non-convex polygon
+        bool same_ring(const std::vector<RingVertex> & a, const std::vector<RingVertex> & b, float tolerance)
+        {
+            auto n = a.size();
+            if(n != b.size() || n == 0)
+                return false;
+
+            for(size_t k = 0; k < n; k++)
+            {
+                if(!same_vertex(a[0], b[k], tolerance))
+                    continue;
+
+                bool forward = true;
+                bool backward = true;
+                for(size_t i = 1; i < n && (forward || backward); i++)
+                {
+                    forward = forward && same_vertex(a[i], b[(k + i) % n], tolerance);
+                    backward = backward && same_vertex(a[i], b[(k + n - i) % n], tolerance);
+                }
+                if(forward || backward)
+                    return true;
+            }
+            return false;
+        }
+
+        void validate_room(FPRoom & room, int32_t room_index, const FPValidationOptions & options, std::vector<FPValidationIssue> & issues)
+        {
+            auto push = [&](EValidationIssue type, int32_t geometry, bool repaired)
+            {
+                FPValidationIssue issue;
+                issue.type = type;
+                issue.room = room_index;
+                issue.geometry = geometry;
+                issue.repaired = repaired;
+                issues.push_back(issue);
+            };
+
+            if(room.type == ERoomType::ENUM_MAX)
+                push(EValidationIssue::UnknownRoomType, -1, false);
+
+            const float tol = std::max(options.snap_tolerance, 0.f);
+            std::vector<std::vector<RingVertex>> kept;
+            std::vector<RingVertex> ring;
+            bool snapped = false;
+            bool changed = false;
+
+            auto g_count = room.geometries.size();
+            for(size_t g = 0; g < g_count; g++)
+            {
+                const auto & points = room.geometries[g].points;
+                ring.clear();
+                ring.reserve(points.size());
+
+                bool merged = false;
+                for(auto & p : points)
+                {
+                    RingVertex v{{p.value.x(), p.value.y()}, p.value.z()};
+                    if(options.repair)
+                    {
+                        Vec2f s{snap_value(v.xy.x(), tol), snap_value(v.xy.y(), tol)};
+                        snapped |= s != v.xy;
+                        v.xy = s;
+                    }
+                    if(!ring.empty() && (ring.back().xy - v.xy).cwiseAbs().maxCoeff() <= tol)
+                    {
+                        merged = true;
+                        continue;
+                    }
+                    ring.push_back(v);
+                }
+                // rings are implicitly closed, an explicit closing vertex is a duplicate
+                while(ring.size() > 1 && (ring.back().xy - ring.front().xy).cwiseAbs().maxCoeff() <= tol)
+                {
+                    ring.pop_back();
+                    merged = true;
+                }
+                if(merged)
+                {
+                    push(EValidationIssue::DuplicateVertex, int32_t(g), options.repair);
+                    changed = true;
+                }
+
+                // a bowtie has zero signed area too, so it has to be caught before the degenerate test drops it
+                if(ring_self_intersects(ring))
+                {
+                    push(EValidationIssue::SelfIntersection, int32_t(g), false);
+                }
+                else if(ring.size() < 3 || std::abs(ring_signed_area(ring)) <= tol * tol)
+                {
+                    push(EValidationIssue::DegenerateRing, int32_t(g), options.repair);
+                    changed = true;
+                    continue;
+                }
+
+                bool duplicate = false;
+                for(auto & k : kept)
+                {
+                    if(same_ring(k, ring, tol))
+                    {
+                        duplicate = true;
+                        break;
+                    }
+                }
+                if(duplicate)
+                {
+                    push(EValidationIssue::DuplicateRing, int32_t(g), options.repair);
+                    changed = true;
+                    continue;
+                }
+
+                kept.push_back(ring);
+            }
+
+            if(kept.empty())
+                push(EValidationIssue::EmptyRoom, -1, false);
+
+            if(!options.repair)
+                return;
+
+            if(!changed)
+            {
+                // same topology, only write the snapped coordinates back
+                if(!snapped)
+                    return;
+                for(auto & geo : room.geometries)
+                {
+                    for(auto & p : geo.points)
+                    {
+                        p.value.x() = snap_value(p.value.x(), tol);
+                        p.value.y() = snap_value(p.value.y(), tol);
+                    }
+                }
+                return;
+            }
+
+            room.geometries.clear();
+            room.geometries.reserve(kept.size());
+            for(auto & r : kept)
+            {
+                FPGeometry geo;
+                geo.points.reserve(r.size());
+                for(auto & v : r)
+                {
+                    FPPoint p;
+                    p.value = {v.xy.x(), v.xy.y(), v.z};
+                    geo.points.push_back(p);
+                }
+                room.geometries.push_back(std::move(geo));
+            }
+        }
+
+        bool is_valid_room_index(int32_t index, size_t room_count)
+        {
+            return index >= 0 && size_t(index) < room_count;
+        }
+
+        float distance_to_room_walls(const FPRoom & room, const Vec2f & p)
+        {
+            float best = std::numeric_limits<float>::max();
+            for(auto & geo : room.geometries)
+            {
+                auto n = geo.points.size();
+                for(size_t i = 0; i < n; i++)
+                {
+                    float d = point_segment_distance_xy(to_xy(geo.points[i]), to_xy(geo.points[(i + 1) % n]), p);
+                    best = std::min(best, d);
+                }
+            }
+            return best;
+        }
+
+        void validate_opening(const FloorPlan & plan, int32_t opening_index, const FPValidationOptions & options, std::vector<FPValidationIssue> & issues)
+        {
+            const auto & opening = plan.openings[opening_index];
+            auto push = [&](EValidationIssue type, int32_t room)
+            {
+                FPValidationIssue issue;
+                issue.type = type;
+                issue.room = room;
+                issue.opening = opening_index;
+                issues.push_back(issue);
+            };
+
+            if(opening.type == EOpeningType::ENUM_MAX)
+                push(EValidationIssue::UnknownOpeningType, -1);
+
+            const auto & c = opening.connection;
+            auto r_count = plan.rooms.size();
+            bool first_ok = is_valid_room_index(c.first, r_count);
+            bool second_ok = c.out || (is_valid_room_index(c.second, r_count) && c.second != c.first);
+            if(!first_ok || !second_ok)
+            {
+                push(EValidationIssue::DanglingConnection, -1);
+                return;
+            }
+
+            Vec2f center = to_xy(opening.position);
+            const Vec3f & half = opening.bounding.xyz;
+            float reach = std::min(std::abs(half.x()), std::abs(half.y())) + options.wall_tolerance;
+
+            if(distance_to_room_walls(plan.rooms[c.first], center) > reach)
+                push(EValidationIssue::OpeningNotOnWall, c.first);
+            if(!c.out && distance_to_room_walls(plan.rooms[c.second], center) > reach)
+                push(EValidationIssue::OpeningNotOnWall, c.second);
+        }
+
+        void append_issues(FPValidationReport & report, std::vector<std::vector<FPValidationIssue>> & per_worker)
+        {
+            for(auto & issues : per_worker)
+            {
+                for(auto & issue : issues)
+                {
+                    if(issue.repaired)
+                        report.repaired_count++;
+                    else
+                        report.error_count++;
+                    report.issues.push_back(issue);
+                }
+                issues.clear();
+            }
+        }
+    }
+
+    const char * validation_issue_name(EValidationIssue issue)
+    {
+        switch(issue)
+        {
+            case EValidationIssue::UnknownRoomType: return "UnknownRoomType";
+            case EValidationIssue::DuplicateRoomName: return "DuplicateRoomName";
+            case EValidationIssue::DuplicateVertex: return "DuplicateVertex";
+            case EValidationIssue::DegenerateRing: return "DegenerateRing";
+            case EValidationIssue::DuplicateRing: return "DuplicateRing";
+            case EValidationIssue::SelfIntersection: return "SelfIntersection";
+            case EValidationIssue::UnknownOpeningType: return "UnknownOpeningType";
+            case EValidationIssue::DanglingConnection: return "DanglingConnection";
+            case EValidationIssue::OpeningNotOnWall: return "OpeningNotOnWall";
+            case EValidationIssue::EmptyRoom: return "EmptyRoom";
+            default: return "Unknown";
+        }
+    }
+
+    FPValidationReport validate_floor_plan(FloorPlan & plan, const FPValidationOptions & options)
+    {
+        FPValidationReport report;
+        std::vector<std::vector<FPValidationIssue>> per_worker(get_worker_count());
+
+        {
+            NameIndex names;
+            names.reserve(plan.rooms.size());
+            auto r_count = plan.rooms.size();
+            for(size_t i = 0; i < r_count; i++)
+            {
+                if(!names.insert(plan.rooms[i].name, int32_t(i)))
+                {
+                    FPValidationIssue issue;
+                    issue.type = EValidationIssue::DuplicateRoomName;
+                    issue.room = int32_t(i);
+                    per_worker[0].push_back(issue);
+                }
+            }
+            append_issues(report, per_worker);
+        }
+
+        parallel_for(plan.rooms.size(), [&](size_t begin, size_t end, uint32_t worker)
+        {
+            for(size_t i = begin; i < end; i++)
+                validate_room(plan.rooms[i], int32_t(i), options, per_worker[worker]);
+        }, 64);
+        append_issues(report, per_worker);
+
+        // openings are checked against the already repaired room geometry
+        parallel_for(plan.openings.size(), [&](size_t begin, size_t end, uint32_t worker)
+        {
+            for(size_t i = begin; i < end; i++)
+                validate_opening(plan, int32_t(i), options, per_worker[worker]);
+        }, 256);
+        append_issues(report, per_worker);
+
+        // snapping alone can move vertices without reporting an issue
+        if(options.repair)
+            invalidate_plan_data(plan);
+
+        return report;
+    }
+}
\ No newline at end of file
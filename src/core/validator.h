@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "core/data.h"
+
+namespace lmcore
+{
+    enum class EValidationIssue
+    {
+        UnknownRoomType = 0,
+        DuplicateRoomName,
+        DuplicateVertex,
+        // fewer than 3 distinct vertices or zero area, dropped when repairing
+        DegenerateRing,
+        DuplicateRing,
+        SelfIntersection,
+        UnknownOpeningType,
+        DanglingConnection,
+        OpeningNotOnWall,
+        // no usable ring left, also reported when repair dropped the last one
+        EmptyRoom,
+
+        ENUM_MAX
+    };
+
+    struct FPValidationIssue
+    {
+        EValidationIssue type;
+        int32_t room = -1;
+        int32_t geometry = -1;
+        int32_t opening = -1;
+
+        bool repaired = false;
+    };
+
+    struct FPValidationOptions
+    {
+        // vertices are snapped to a grid of this size and closer vertices are merged.
+        // <= 0 disables snapping, only exactly equal vertices are merged
+        float snap_tolerance = 1e-3f;
+        // how far an opening center may sit from a wall, on top of its own half thickness
+        float wall_tolerance = 0.05f;
+
+        bool repair = true;
+    };
+
+    struct FPValidationReport
+    {
+        std::vector<FPValidationIssue> issues;
+        uint32_t error_count = 0;
+        uint32_t repaired_count = 0;
+
+        bool valid() const { return error_count == 0; }
+    };
+
+    const char * validation_issue_name(EValidationIssue issue);
+
+    // checks every room and opening of the plan, rooms and openings are processed in parallel.
+    // with options.repair set the plan is fixed in place where possible (snapping, vertex and ring dedup)
+    FPValidationReport validate_floor_plan(FloorPlan & plan, const FPValidationOptions & options = {});
+}
\ No newline at end of file
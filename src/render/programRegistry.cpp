@@ -0,0 +1,126 @@
+#include "programRegistry.h"
+
+#include <cstring>
+#include <iostream>
+#include <string_view>
+
+#include "system/shaderArchive.h"
+
+namespace lmv
+{
+namespace
+{
+    struct ProgramDesc
+    {
+        EProgram program;
+        const char * vs;
+        const char * fs;
+    };
+
+    const ProgramDesc kPrograms[] = {
+        {EProgram::Basic, "vs_basic", "fs_basic"},
+        {EProgram::Grid,  "vs_grid",  "fs_grid"},
+    };
+
+    // profiles in order of preference, must match LAYMANN_SHADER_PROFILES in CMakeLists.txt
+    std::vector<std::string_view> profilesFor(bgfx::RendererType::Enum type)
+    {
+        switch (type)
+        {
+            case bgfx::RendererType::OpenGL:     return {"120", "440"};
+            case bgfx::RendererType::OpenGLES:   return {"300_es", "100_es"};
+            case bgfx::RendererType::Vulkan:     return {"spirv"};
+            case bgfx::RendererType::Metal:      return {"metal"};
+            case bgfx::RendererType::Direct3D11:
+            case bgfx::RendererType::Direct3D12: return {"s_5_0"};
+            default:                             return {};
+        }
+    }
+}
+
+bool ProgramRegistry::init(const std::string & archivePath)
+{
+    shutdown();
+
+    ShaderArchive archive;
+    if (!archive.open(archivePath))
+    {
+        std::cerr << "Failed to open shader archive: " << archivePath << std::endl;
+        return false;
+    }
+
+    for (auto p : profilesFor(bgfx::getRendererType()))
+    {
+        if (archive.hasProfile(p))
+        {
+            profile = p;
+            break;
+        }
+    }
+    if (profile.empty())
+    {
+        std::cerr << "Shader archive has no profile for renderer " << bgfx::getRendererName(bgfx::getRendererType()) << std::endl;
+        return false;
+    }
+
+    auto getShader = [&](const char * name) -> bgfx::ShaderHandle
+    {
+        for (auto & s : shaders)
+        {
+            if (s.name == name)
+                return s.handle;
+        }
+
+        const uint8_t * data = nullptr;
+        uint32_t size = 0;
+        bgfx::ShaderHandle handle = BGFX_INVALID_HANDLE;
+        if (archive.find(profile, name, data, size))
+        {
+            const bgfx::Memory * mem = bgfx::alloc(size + 1);
+            std::memcpy(mem->data, data, size);
+            mem->data[size] = '\0';
+            handle = bgfx::createShader(mem);
+            bgfx::setName(handle, name, (int32_t)std::strlen(name));
+        }
+        else
+        {
+            std::cerr << "Shader " << name << " missing from archive for profile " << profile << std::endl;
+        }
+        shaders.push_back({name, handle});
+        return handle;
+    };
+
+    bool ok = true;
+    for (auto & desc : kPrograms)
+    {
+        bgfx::ShaderHandle vsh = getShader(desc.vs);
+        bgfx::ShaderHandle fsh = getShader(desc.fs);
+        if (!bgfx::isValid(vsh) || !bgfx::isValid(fsh))
+        {
+            std::cerr << "Invalid shader handles!" << std::endl;
+            ok = false;
+            continue;
+        }
+        // shaders are shared between programs, the registry destroys them itself
+        programs[(size_t)desc.program] = bgfx::createProgram(vsh, fsh, false);
+    }
+    return ok;
+}
+
+void ProgramRegistry::shutdown()
+{
+    for (auto & p : programs)
+    {
+        if (bgfx::isValid(p))
+            bgfx::destroy(p);
+        p = BGFX_INVALID_HANDLE;
+    }
+    for (auto & s : shaders)
+    {
+        if (bgfx::isValid(s.handle))
+            bgfx::destroy(s.handle);
+    }
+    shaders.clear();
+    profile.clear();
+}
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+#include <array>
+#include <string>
+#include <vector>
+
+#include <bgfx/bgfx.h>
+
+namespace lmv
+{
+    enum class EProgram
+    {
+        Basic = 0,
+        Grid,
+
+        ENUM_MAX
+    };
+
+    // creates every program from the packed shader archive in one go.
+    // shaders used by several programs are created once and owned by the registry
+    class ProgramRegistry
+    {
+    public:
+        ProgramRegistry() { programs.fill(BGFX_INVALID_HANDLE); }
+
+        // call after bgfx::init, picks the archive profile matching the active renderer
+        bool init(const std::string & archivePath);
+        void shutdown();
+
+        bgfx::ProgramHandle get(EProgram program) const { return programs[(size_t)program]; }
+        const std::string & getProfile() const { return profile; }
+
+    private:
+        struct CachedShader
+        {
+            std::string name;
+            bgfx::ShaderHandle handle;
+        };
+
+        std::string profile;
+        std::vector<CachedShader> shaders;
+        std::array<bgfx::ProgramHandle, (size_t)EProgram::ENUM_MAX> programs;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+#include "storeyMeshes.h"
+
+namespace lmv
+{
+namespace
+{
+    const float kRoomColors[(size_t)lmcore::ERoomType::ENUM_MAX][3] = {
+        {0.9f, 0.6f, 0.3f}, // LivingRoom
+        {0.4f, 0.6f, 0.9f}, // Bedroom
+        {0.9f, 0.8f, 0.3f}, // DiningRoom
+        {0.4f, 0.8f, 0.4f}, // Kitchen
+        {0.6f, 0.8f, 0.9f}, // Bathroom
+    };
+}
+
+size_t StoreyMeshes::create(uint32_t storey, const lmcore::FloorPlan & plan, float elevation)
+{
+    destroy(storey);
+
+    std::vector<lmcore::PosColorVertex> vertices;
+    std::vector<uint32_t> indices;
+    for (auto & room : plan.rooms)
+    {
+        size_t type = (size_t)room.type < (size_t)lmcore::ERoomType::ENUM_MAX ? (size_t)room.type : 0;
+        const float * c = kRoomColors[type];
+        for (auto & geo : room.geometries)
+        {
+            uint32_t first = (uint32_t)vertices.size();
+            uint32_t count = (uint32_t)geo.points.size();
+            if (count < 2)
+                continue;
+            for (auto & p : geo.points)
+                vertices.push_back({p.value.x(), p.value.y(), elevation + p.value.z(), 0.f, 0.f, 1.f, c[0], c[1], c[2], 1.f});
+            // closed outline, one line per ring edge
+            for (uint32_t i = 0; i < count; i++)
+            {
+                indices.push_back(first + i);
+                indices.push_back(first + (i + 1) % count);
+            }
+        }
+    }
+    if (indices.empty())
+        return 0;
+
+    if (meshes.size() <= storey)
+        meshes.resize(storey + 1);
+    Mesh & mesh = meshes[storey];
+    uint32_t vertexBytes = (uint32_t)(vertices.size() * sizeof(lmcore::PosColorVertex));
+    uint32_t indexBytes = (uint32_t)(indices.size() * sizeof(uint32_t));
+    mesh.vbh = bgfx::createVertexBuffer(bgfx::copy(vertices.data(), vertexBytes), layout);
+    mesh.ibh = bgfx::createIndexBuffer(bgfx::copy(indices.data(), indexBytes), BGFX_BUFFER_INDEX32);
+    return (size_t)vertexBytes + indexBytes;
+}
+
+void StoreyMeshes::destroy(uint32_t storey)
+{
+    if (storey >= meshes.size())
+        return;
+    Mesh & mesh = meshes[storey];
+    if (bgfx::isValid(mesh.vbh))
+        bgfx::destroy(mesh.vbh);
+    if (bgfx::isValid(mesh.ibh))
+        bgfx::destroy(mesh.ibh);
+    mesh = Mesh();
+}
+
+void StoreyMeshes::shutdown()
+{
+    for (uint32_t s = 0; s < (uint32_t)meshes.size(); s++)
+        destroy(s);
+    meshes.clear();
+}
+
+void StoreyMeshes::submit(bgfx::ViewId view, bgfx::ProgramHandle program, uint64_t state) const
+{
+    float mtx[16] = {1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f};
+    for (auto & mesh : meshes)
+    {
+        if (!bgfx::isValid(mesh.vbh))
+            continue;
+        bgfx::setTransform(mtx);
+        bgfx::setVertexBuffer(0, mesh.vbh);
+        bgfx::setIndexBuffer(mesh.ibh);
+        bgfx::setState(state);
+        bgfx::submit(view, program);
+    }
+}
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include <bgfx/bgfx.h>
+
+#include "core/data.h"
+
+namespace lmv
+{
+    // gpu line meshes of the room outlines of every resident storey, indexed like the storeys of a Building.
+    // create and destroy are meant to be called from the Building residency hooks, on the render thread
+    class StoreyMeshes
+    {
+    public:
+        explicit StoreyMeshes(const bgfx::VertexLayout & layout) : layout(layout) {}
+
+        // returns the bytes uploaded to the gpu, 0 if the plan has no outline to draw
+        size_t create(uint32_t storey, const lmcore::FloorPlan & plan, float elevation);
+        void destroy(uint32_t storey);
+        void shutdown();
+
+        // one draw call per resident storey, state must include a line primitive type
+        void submit(bgfx::ViewId view, bgfx::ProgramHandle program, uint64_t state) const;
+
+    private:
+        struct Mesh
+        {
+            bgfx::VertexBufferHandle vbh = BGFX_INVALID_HANDLE;
+            bgfx::IndexBufferHandle ibh = BGFX_INVALID_HANDLE;
+        };
+
+        bgfx::VertexLayout layout;
+        std::vector<Mesh> meshes;
+    };
+}
@@ -1,10 +1,15 @@
 #include "files.h"
 
+#include <fstream>
+
 #ifdef PLATFORM_WINDOWS
 
 #elif defined(PLATFORM_LINUX)
     #include <unistd.h>
     #include <limits.h>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
 #elif defined(PLATFORM_MACOS)
 
 #endif
@@ -38,4 +43,62 @@ std::string getShaderPath()
 
     return path + "/shaders";
 }
+
+std::string getShaderArchivePath()
+{
+    return getShaderPath() + "/shaders.pak";
+}
+
+bool mapFile(const std::string & path, MappedFile & file)
+{
+    unmapFile(file);
+#if defined(PLATFORM_LINUX)
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    void * ptr = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (ptr == MAP_FAILED)
+        return false;
+    file.data = (const uint8_t *)ptr;
+    file.size = (size_t)st.st_size;
+    file.mapped = true;
+    return true;
+#else
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in.is_open())
+        return false;
+    std::streamsize size = in.tellg();
+    if (size <= 0)
+        return false;
+    in.seekg(0, std::ios::beg);
+    file.buffer.resize((size_t)size);
+    if (!in.read((char *)file.buffer.data(), size))
+    {
+        file.buffer.clear();
+        return false;
+    }
+    file.data = file.buffer.data();
+    file.size = file.buffer.size();
+    return true;
+#endif
+}
+
+void unmapFile(MappedFile & file)
+{
+#if defined(PLATFORM_LINUX)
+    if (file.mapped)
+        munmap((void *)file.data, file.size);
+#endif
+    file.buffer.clear();
+    file.data = nullptr;
+    file.size = 0;
+    file.mapped = false;
+}
 }
\ No newline at end of file
@@ -1,8 +1,26 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace lmv
 {
     std::string getExePath();
     std::string getExeFolderPath();
     std::string getShaderPath();
+    std::string getShaderArchivePath();
+
+    // read only view of a whole file, memory mapped where the platform allows it
+    struct MappedFile
+    {
+        const uint8_t * data = nullptr;
+        size_t size = 0;
+
+        bool mapped = false;
+        std::vector<uint8_t> buffer;
+    };
+
+    bool mapFile(const std::string & path, MappedFile & file);
+    void unmapFile(MappedFile & file);
 }
\ No newline at end of file
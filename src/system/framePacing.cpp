@@ -0,0 +1,54 @@
+#include "framePacing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <numeric>
+
+namespace lmv
+{
+bool saveInputReplay(const std::string & path, const std::vector<FrameInput> & frames)
+{
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open())
+        return false;
+    for (auto & f : frames)
+        file << f.moveForward << ' ' << f.moveRight << ' ' << f.moveUp << ' ' << f.mouseDx << ' ' << f.mouseDy << ' ' << f.dt << '\n';
+    return file.good();
+}
+
+bool loadInputReplay(const std::string & path, std::vector<FrameInput> & frames)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+        return false;
+    frames.clear();
+    FrameInput f;
+    while (file >> f.moveForward >> f.moveRight >> f.moveUp >> f.mouseDx >> f.mouseDy >> f.dt)
+        frames.push_back(f);
+    return !frames.empty();
+}
+
+FrameTimeStats computeFrameTimeStats(std::vector<double> frameMs)
+{
+    FrameTimeStats stats;
+    stats.frames = frameMs.size();
+    if (frameMs.empty())
+        return stats;
+
+    std::sort(frameMs.begin(), frameMs.end());
+    // nearest rank percentile
+    auto percentile = [&](double p)
+    {
+        size_t rank = (size_t)std::ceil(p * (double)frameMs.size());
+        return frameMs[std::clamp<size_t>(rank, 1, frameMs.size()) - 1];
+    };
+
+    stats.mean = std::accumulate(frameMs.begin(), frameMs.end(), 0.0) / (double)frameMs.size();
+    stats.p50 = percentile(0.50);
+    stats.p95 = percentile(0.95);
+    stats.p99 = percentile(0.99);
+    stats.max = frameMs.back();
+    return stats;
+}
+}
\ No newline at end of file
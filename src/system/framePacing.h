@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace lmv
+{
+    // camera input of one frame, what the render loop reads from glfw
+    struct FrameInput
+    {
+        float moveForward = 0.0f;
+        float moveRight = 0.0f;
+        float moveUp = 0.0f;
+        float mouseDx = 0.0f;
+        float mouseDy = 0.0f;
+        float dt = 0.0f;
+
+        bool isIdle() const
+        {
+            return moveForward == 0.0f && moveRight == 0.0f && moveUp == 0.0f && mouseDx == 0.0f && mouseDy == 0.0f;
+        }
+    };
+
+    // plain text, one frame per line
+    bool saveInputReplay(const std::string & path, const std::vector<FrameInput> & frames);
+    bool loadInputReplay(const std::string & path, std::vector<FrameInput> & frames);
+
+    struct FrameTimeStats
+    {
+        size_t frames = 0;
+        double mean = 0.0;
+        double p50 = 0.0;
+        double p95 = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+    };
+
+    FrameTimeStats computeFrameTimeStats(std::vector<double> frameMs);
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include "shaderArchive.h"
+
+#include <cstring>
+
+namespace lmv
+{
+namespace
+{
+    std::string_view fixedString(const char * str, size_t capacity)
+    {
+        return std::string_view(str, strnlen(str, capacity));
+    }
+}
+
+bool ShaderArchive::open(const std::string & path)
+{
+    close();
+    if (!mapFile(path, file))
+        return false;
+
+    if (file.size < sizeof(ShaderArchiveHeader))
+    {
+        close();
+        return false;
+    }
+
+    ShaderArchiveHeader header;
+    std::memcpy(&header, file.data, sizeof(header));
+    size_t tableEnd = sizeof(header) + size_t(header.entryCount) * sizeof(ShaderArchiveEntry);
+    if (header.magic != kShaderArchiveMagic || header.version != kShaderArchiveVersion || tableEnd > file.size)
+    {
+        close();
+        return false;
+    }
+
+    entries = (const ShaderArchiveEntry *)(file.data + sizeof(header));
+    entryCount = header.entryCount;
+    for (uint32_t i = 0; i < entryCount; i++)
+    {
+        if (size_t(entries[i].offset) + entries[i].size > file.size)
+        {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void ShaderArchive::close()
+{
+    unmapFile(file);
+    entries = nullptr;
+    entryCount = 0;
+}
+
+bool ShaderArchive::hasProfile(std::string_view profile) const
+{
+    for (uint32_t i = 0; i < entryCount; i++)
+    {
+        if (fixedString(entries[i].profile, sizeof(entries[i].profile)) == profile)
+            return true;
+    }
+    return false;
+}
+
+bool ShaderArchive::find(std::string_view profile, std::string_view name, const uint8_t *& data, uint32_t & size) const
+{
+    for (uint32_t i = 0; i < entryCount; i++)
+    {
+        const auto & e = entries[i];
+        if (fixedString(e.profile, sizeof(e.profile)) == profile && fixedString(e.name, sizeof(e.name)) == name)
+        {
+            data = file.data + e.offset;
+            size = e.size;
+            return true;
+        }
+    }
+    return false;
+}
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "system/files.h"
+
+namespace lmv
+{
+    // packed shader archive written by tools/shader_pack at build time:
+    // header, entry table, then 16 byte aligned blobs. entries with identical bytes share a blob
+    constexpr uint32_t kShaderArchiveMagic = 0x50534d4c; // "LMSP"
+    constexpr uint32_t kShaderArchiveVersion = 1;
+
+    struct ShaderArchiveHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t reserved;
+    };
+
+    struct ShaderArchiveEntry
+    {
+        char profile[16];
+        char name[32];
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    class ShaderArchive
+    {
+    public:
+        ~ShaderArchive() { close(); }
+
+        bool open(const std::string & path);
+        void close();
+
+        bool hasProfile(std::string_view profile) const;
+        // data points into the mapping and stays valid until close()
+        bool find(std::string_view profile, std::string_view name, const uint8_t *& data, uint32_t & size) const;
+
+    private:
+        MappedFile file;
+        const ShaderArchiveEntry * entries = nullptr;
+        uint32_t entryCount = 0;
+    };
+}
\ No newline at end of file
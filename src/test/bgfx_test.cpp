@@ -1,10 +1,12 @@
 #include <cstdio>
 #include <cstdint>
+#include <cstdlib>
 #include <cmath>
 #include <vector>
 #include <string>
 #include <fstream>
 #include <iostream>
+#include <chrono>
 
 #include <bgfx/bgfx.h>
 #include <bgfx/platform.h>
@@ -14,8 +16,13 @@
 #include <GLFW/glfw3.h>
 
 #include "system/files.h"
+#include "system/framePacing.h"
+#include "render/programRegistry.h"
+#include "render/storeyMeshes.h"
+#include "utils/building.h"
 #include "utils/planLoader.h"
 #include "core/utils.h"
+#include "core/validator.h"
 
 #define GLFW_EXPOSE_NATIVE_X11
 #include <GLFW/glfw3native.h>
@@ -156,67 +163,115 @@ static lmcore::PosColorVertex cubeVertices[36] = {
     {1.0f, -1.0f, -1.0f,  0.0f, 0.0f,-1.0f,  1.0f, 1.0f, 0.0f}
 };
 
-static bgfx::ShaderHandle loadShaderBin(const char* _path)
+struct WindowState
 {
-    std::string path = _path;
+    int width = 0;
+    int height = 0;
+    bool resized = false;
+    bool exposed = false;
+};
 
-    std::ifstream file(path, std::ios::binary | std::ios::ate);
-    if (!file.is_open())
-    {
-        std::cerr << "Failed to open shader file: " << path << std::endl;
-        return BGFX_INVALID_HANDLE;
-    }
+static void onFramebufferSize(GLFWwindow* window, int w, int h)
+{
+    auto* state = (WindowState*)glfwGetWindowUserPointer(window);
+    state->width = w;
+    state->height = h;
+    state->resized = true;
+}
+
+static void onWindowRefresh(GLFWwindow* window)
+{
+    auto* state = (WindowState*)glfwGetWindowUserPointer(window);
+    state->exposed = true;
+}
 
-    std::streamsize size = file.tellg();
-    file.seekg(0, std::ios::beg);
+struct LaunchOptions
+{
+    // only render when the camera or the window changed
+    bool onDemand = false;
+    // replay recorded input without vsync and report frame times
+    std::string benchmarkReplay;
+    std::string recordReplay;
+    // plans stacked bottom up as the storeys of a building, paged in around the camera
+    std::vector<std::string> storeyPlans;
+    float storeyHeight = 3.0f;
+};
 
-    const bgfx::Memory* mem = bgfx::alloc(uint32_t(size + 1));
-    if (!file.read((char*)mem->data, size))
+static bool parseLaunchOptions(int argc, char** argv, LaunchOptions& options)
+{
+    for (int i = 1; i < argc; i++)
     {
-        std::cerr << "Failed to read shader file: " << path << std::endl;
-        return BGFX_INVALID_HANDLE;
+        std::string arg = argv[i];
+        if (arg == "--on-demand")
+            options.onDemand = true;
+        else if (arg == "--benchmark" && i + 1 < argc)
+            options.benchmarkReplay = argv[++i];
+        else if (arg == "--record" && i + 1 < argc)
+            options.recordReplay = argv[++i];
+        else if (arg == "--storey" && i + 1 < argc)
+            options.storeyPlans.push_back(argv[++i]);
+        else if (arg == "--storey-height" && i + 1 < argc)
+            options.storeyHeight = (float)std::atof(argv[++i]);
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--on-demand] [--record <replay>] [--benchmark <replay>] [--storey <plan.json>]... [--storey-height <m>]\n", argv[0]);
+            return false;
+        }
     }
-
-    mem->data[size] = '\0';
-
-    bgfx::ShaderHandle handle = bgfx::createShader(mem);
-    bgfx::setName(handle, path.c_str(), (uint16_t)path.size());
-
-    return handle;
+    return true;
 }
 
-static bgfx::ProgramHandle createSimpleProgram()
+static lmv::FrameInput readFrameInput(GLFWwindow* window, bool& rotating, double& lastMouseX, double& lastMouseY)
 {
-    auto shaderpath = lmv::getShaderPath();
-    bgfx::ShaderHandle vsh = loadShaderBin((shaderpath + "/vs_basic.bin").c_str());
-    bgfx::ShaderHandle fsh = loadShaderBin((shaderpath + "/fs_basic.bin").c_str());
+    lmv::FrameInput input;
+
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) input.moveForward += 1.0f;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) input.moveForward -= 1.0f;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) input.moveRight   -= 1.0f;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) input.moveRight   += 1.0f;
+    if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS) input.moveUp      += 1.0f;
+    if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS) input.moveUp      -= 1.0f;
 
-    if (!bgfx::isValid(vsh) || !bgfx::isValid(fsh))
+    if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_RIGHT) == GLFW_PRESS)
+    {
+        double mx, my;
+        glfwGetCursorPos(window, &mx, &my);
+
+        if (!rotating)
+        {
+            rotating = true;
+        }
+        else
+        {
+            input.mouseDx = (float)(mx - lastMouseX);
+            input.mouseDy = (float)(my - lastMouseY);
+        }
+        lastMouseX = mx;
+        lastMouseY = my;
+    }
+    else
     {
-        std::cerr << "Invalid shader handles!" << std::endl;
-        return BGFX_INVALID_HANDLE;
+        rotating = false;
     }
 
-    return bgfx::createProgram(vsh, fsh, true /* destroy shaders when program destroyed */);
+    return input;
 }
 
-static bgfx::ProgramHandle createGridProgram()
+int main(int argc, char** argv)
 {
-    auto shaderpath = lmv::getShaderPath();
-    bgfx::ShaderHandle vsh = loadShaderBin((shaderpath + "/vs_grid.bin").c_str());
-    bgfx::ShaderHandle fsh = loadShaderBin((shaderpath + "/fs_grid.bin").c_str());
+    LaunchOptions options;
+    if (!parseLaunchOptions(argc, argv, options))
+        return -1;
 
-    if (!bgfx::isValid(vsh) || !bgfx::isValid(fsh))
+    const bool benchmark = !options.benchmarkReplay.empty();
+    std::vector<lmv::FrameInput> replay;
+    if (benchmark && !lmv::loadInputReplay(options.benchmarkReplay, replay))
     {
-        std::cerr << "Invalid shader handles!" << std::endl;
-        return BGFX_INVALID_HANDLE;
+        std::fprintf(stderr, "Failed to load input replay %s\n", options.benchmarkReplay.c_str());
+        return -1;
     }
+    const uint32_t resetFlags = benchmark ? BGFX_RESET_NONE : BGFX_RESET_VSYNC;
 
-    return bgfx::createProgram(vsh, fsh, true /* destroy shaders when program destroyed */);
-}
-
-int main()
-{
     lmcore::FPLineSegment first;
     first.start.value.x() = -1.f;
     first.end.value.x() = 1.f;
@@ -231,7 +286,22 @@ int main()
     auto res = lmcore::find_segment_intersection_xy(first,second,i_pos);
     auto rootpath = lmv::getExeFolderPath();
     auto plan_0_path = rootpath + std::string("/data/plan/l_singleStudio01.json");
-    auto fp_0 = lmv::load_floor_plan_from_json(plan_0_path);
+    lmcore::FloorPlan fp_0;
+    try
+    {
+        fp_0 = lmv::load_floor_plan_from_json(plan_0_path);
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "Failed to load plan %s: %s\n", plan_0_path.c_str(), e.what());
+    }
+    auto fp_0_report = lmcore::validate_floor_plan(fp_0);
+    for(auto & issue : fp_0_report.issues)
+    {
+        if(!issue.repaired)
+            std::fprintf(stderr, "%s: %s (room %d, opening %d)\n", plan_0_path.c_str(),
+                lmcore::validation_issue_name(issue.type), issue.room, issue.opening);
+    }
 
     if (!glfwInit())
     {
@@ -266,7 +336,7 @@ int main()
 
     init.resolution.width  = (uint32_t)width;
     init.resolution.height = (uint32_t)height;
-    init.resolution.reset  = BGFX_RESET_VSYNC;
+    init.resolution.reset  = resetFlags;
 
     if (!bgfx::init(init))
     {
@@ -297,28 +367,33 @@ int main()
     bgfx::VertexBufferHandle vbh_grid = bgfx::createVertexBuffer(bgfx::makeRef(gridVertices, sizeof(gridVertices)),s_PosColorLayout);
     bgfx::IndexBufferHandle ibh_grid = bgfx::createIndexBuffer(bgfx::makeRef(gridIndices, sizeof(gridIndices)));
 
-    bgfx::ProgramHandle program = createSimpleProgram();
-    if (!bgfx::isValid(program))
+    lmv::ProgramRegistry programs;
+    if (!programs.init(lmv::getShaderArchivePath()))
     {
         std::fprintf(stderr, "Failed to create program. Check your shaders.\n");
+        programs.shutdown();
         bgfx::shutdown();
         glfwDestroyWindow(window);
         glfwTerminate();
         return -1;
     }
 
-    bgfx::ProgramHandle program_grid = createGridProgram();
-    if (!bgfx::isValid(program_grid))
-    {
-        std::fprintf(stderr, "Failed to create program. Check your shaders.\n");
-        bgfx::shutdown();
-        glfwDestroyWindow(window);
-        glfwTerminate();
-        return -1;
-    }
+    bgfx::ProgramHandle program = programs.get(lmv::EProgram::Basic);
+    bgfx::ProgramHandle program_grid = programs.get(lmv::EProgram::Grid);
 
     bgfx::UniformHandle u_camera = bgfx::createUniform("u_camera", bgfx::UniformType::Vec4);
 
+    // the hooks run inside building.update(), on this thread, so they can create and destroy bgfx buffers
+    lmv::StoreyMeshes storeyMeshes(s_PosColorLayout);
+    lmv::Building building;
+    for (size_t i = 0; i < options.storeyPlans.size(); i++)
+        building.add_storey(options.storeyPlans[i], (float)i * options.storeyHeight);
+    building.set_hooks({
+        [&](uint32_t storey, const lmcore::FloorPlan& plan, float elevation) { return storeyMeshes.create(storey, plan, elevation); },
+        [&](uint32_t storey) { storeyMeshes.destroy(storey); }
+    });
+    lmv::BuildingStats buildingStats = building.get_stats();
+
     Vec3 cameraPos{0.0f, -5.0f, 0.0f}; 
     float yaw   = 3.1415926f;                
     float pitch = 0.0f;                
@@ -334,64 +409,88 @@ int main()
 
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
 
+    WindowState windowState;
+    glfwSetWindowUserPointer(window, &windowState);
+    glfwSetFramebufferSizeCallback(window, onFramebufferSize);
+    glfwSetWindowRefreshCallback(window, onWindowRefresh);
+    glfwGetFramebufferSize(window, &windowState.width, &windowState.height);
+    windowState.resized = true;
+
+    float view[16];
+    float proj[16];
+    const float nearp = 0.1f;
+    const float farp = 100.f;
+    float nf[4] = {nearp, farp, 0, 0};
+    bool viewDirty = true;
+    bool projDirty = true;
+    bool idle = false;
+
+    size_t replayFrame = 0;
+    std::vector<lmv::FrameInput> recorded;
+    std::vector<double> frameTimes;
+    frameTimes.reserve(replay.size());
+
     while (!glfwWindowShouldClose(window))
     {
-        double currentTime = glfwGetTime();
-        float dt = (float)(currentTime - lastTime);
-        lastTime = currentTime;
+        auto frameStart = std::chrono::steady_clock::now();
 
-        glfwPollEvents();
-
-        int fbW, fbH;
-        glfwGetFramebufferSize(window, &fbW, &fbH);
-        if (fbW != width || fbH != height)
+        // nothing to draw, sleep until glfw has a new event. finished storey loads do not post one,
+        // so only nap while some are in flight
+        if (options.onDemand && idle)
         {
-            width = fbW;
-            height = fbH;
-            bgfx::reset((uint32_t)width, (uint32_t)height, BGFX_RESET_VSYNC);
-            bgfx::setViewRect(kViewId, 0, 0, (uint16_t)width, (uint16_t)height);
+            if (buildingStats.pending > 0)
+                glfwWaitEventsTimeout(0.01);
+            else
+                glfwWaitEvents();
+            lastTime = glfwGetTime();
+        }
+        else
+        {
+            glfwPollEvents();
         }
 
-        float moveForward = 0.0f;
-        float moveRight   = 0.0f;
-        float moveUp      = 0.0f;
-
-        if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) moveForward += 1.0f;
-        if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) moveForward -= 1.0f;
-        if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) moveRight   -= 1.0f;
-        if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) moveRight   += 1.0f;
-        if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS) moveUp      += 1.0f;
-        if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS) moveUp      -= 1.0f;
+        double currentTime = glfwGetTime();
+        float dt = (float)(currentTime - lastTime);
+        lastTime = currentTime;
 
-        if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_RIGHT) == GLFW_PRESS)
+        if (windowState.resized)
         {
-            double mx, my;
-            glfwGetCursorPos(window, &mx, &my);
-
-            if (!rotating)
+            windowState.resized = false;
+            if (windowState.width != width || windowState.height != height)
             {
-                rotating = true;
-                lastMouseX = mx;
-                lastMouseY = my;
+                width = windowState.width;
+                height = windowState.height;
+                bgfx::reset((uint32_t)width, (uint32_t)height, resetFlags);
+                bgfx::setViewRect(kViewId, 0, 0, (uint16_t)width, (uint16_t)height);
             }
-            else
-            {
-                double dx = mx - lastMouseX;
-                double dy = my - lastMouseY;
-                lastMouseX = mx;
-                lastMouseY = my;
-
-                yaw   -= (float)dx * mouseSensitivity;
-                pitch -= (float)dy * mouseSensitivity;
+            projDirty = true;
+        }
 
-                const float limit = bx::toRad(89.0f);
-                if (pitch >  limit) pitch =  limit;
-                if (pitch < -limit) pitch = -limit;
-            }
+        lmv::FrameInput input;
+        if (benchmark)
+        {
+            if (replayFrame >= replay.size())
+                break;
+            input = replay[replayFrame++];
+            dt = input.dt;
         }
         else
         {
-            rotating = false;
+            input = readFrameInput(window, rotating, lastMouseX, lastMouseY);
+            input.dt = dt;
+        }
+        if (!options.recordReplay.empty())
+            recorded.push_back(input);
+
+        if (input.mouseDx != 0.0f || input.mouseDy != 0.0f)
+        {
+            yaw   -= input.mouseDx * mouseSensitivity;
+            pitch -= input.mouseDy * mouseSensitivity;
+
+            const float limit = bx::toRad(89.0f);
+            if (pitch >  limit) pitch =  limit;
+            if (pitch < -limit) pitch = -limit;
+            viewDirty = true;
         }
 
         Vec3 forward{
@@ -405,36 +504,56 @@ int main()
         Vec3 right = normalize(cross(forward, worldUp));
         Vec3 up    = cross(right, forward);
 
-        Vec3 moveDir{
-            forward.x * moveForward + right.x * moveRight + up.x * moveUp,
-            forward.y * moveForward + right.y * moveRight + up.y * moveUp,
-            forward.z * moveForward + right.z * moveRight + up.z * moveUp
-        };
-
-        if (moveForward != 0.0f || moveRight != 0.0f || moveUp != 0.0f)
+        if (input.moveForward != 0.0f || input.moveRight != 0.0f || input.moveUp != 0.0f)
         {
+            Vec3 moveDir{
+                forward.x * input.moveForward + right.x * input.moveRight + up.x * input.moveUp,
+                forward.y * input.moveForward + right.y * input.moveRight + up.y * input.moveUp,
+                forward.z * input.moveForward + right.z * input.moveRight + up.z * input.moveUp
+            };
             moveDir = normalize(moveDir);
             cameraPos = cameraPos + moveDir * (moveSpeed * dt);
+            viewDirty = true;
         }
 
-        float view[16];
-        float proj[16];
+        // pages storeys in and out around the camera, uploads and frees their meshes through the hooks
+        building.update(lmcore::Vec3f(cameraPos.x, cameraPos.y, cameraPos.z));
+        lmv::BuildingStats lastBuildingStats = buildingStats;
+        buildingStats = building.get_stats();
+        bool storeysChanged = buildingStats.loads != lastBuildingStats.loads || buildingStats.evictions != lastBuildingStats.evictions;
+
+        bool redraw = !options.onDemand || viewDirty || projDirty || windowState.exposed || storeysChanged;
+        // held movement keys keep polling so movement stays smooth. a held mouse button does not,
+        // cursor motion already wakes glfwWaitEvents
+        idle = !redraw && input.isIdle();
+        if (!redraw)
+            continue;
+        windowState.exposed = false;
+
+        if (viewDirty)
+        {
+            bx::Vec3 eye = { cameraPos.x, cameraPos.y, cameraPos.z };
+            bx::Vec3 at  = { cameraPos.x + forward.x,
+                             cameraPos.y + forward.y,
+                             cameraPos.z + forward.z };
+            bx::Vec3 upArr = { up.x, up.y, up.z };
 
-        bx::Vec3 eye = { cameraPos.x, cameraPos.y, cameraPos.z };
-        bx::Vec3 at  = { cameraPos.x + forward.x,
-                         cameraPos.y + forward.y,
-                         cameraPos.z + forward.z };
-        bx::Vec3 upArr = { up.x, up.y, up.z };
+            bx::mtxLookAt(view, eye, at, upArr);
+        }
 
-        bx::mtxLookAt(view, eye, at, upArr);
+        if (projDirty)
+        {
+            float aspect = (height > 0) ? (float)width / (float)height : 1.0f;
+            const bgfx::Caps* caps = bgfx::getCaps();
+            bx::mtxProj(proj, 60.0f, aspect, nearp, farp, caps->homogeneousDepth);
+        }
 
-        float aspect = (height > 0) ? (float)width / (float)height : 1.0f;
-        const bgfx::Caps* caps = bgfx::getCaps();
-        float nearp = 0.1f;
-        float farp = 100.f;
-        float nf[4] = {nearp, farp, 0, 0};
-        bx::mtxProj(proj, 60.0f, aspect, nearp, farp, caps->homogeneousDepth);
-        bgfx::setViewTransform(kViewId, view, proj);
+        if (viewDirty || projDirty)
+        {
+            bgfx::setViewTransform(kViewId, view, proj);
+            viewDirty = false;
+            projDirty = false;
+        }
 
         float mtx[16];
         bx::mtxIdentity(mtx);
@@ -457,6 +576,15 @@ int main()
         );
         bgfx::submit(kViewId, program_grid);
 
+        storeyMeshes.submit(kViewId, program_grid,
+            BGFX_STATE_WRITE_RGB
+          | BGFX_STATE_WRITE_A
+          | BGFX_STATE_WRITE_Z
+          | BGFX_STATE_DEPTH_TEST_LESS
+          | BGFX_STATE_MSAA
+          | BGFX_STATE_PT_LINES
+        );
+
         bgfx::setVertexBuffer(0, vbh);
         //bgfx::setIndexBuffer(ibh);
         bgfx::setUniform(u_camera, nf);
@@ -471,15 +599,32 @@ int main()
         bgfx::submit(kViewId, program);
 
         bgfx::frame();
+
+        if (benchmark)
+            frameTimes.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count());
     }
 
+    if (!options.recordReplay.empty() && !lmv::saveInputReplay(options.recordReplay, recorded))
+        std::fprintf(stderr, "Failed to write input replay %s\n", options.recordReplay.c_str());
+
+    if (benchmark)
+    {
+        auto stats = lmv::computeFrameTimeStats(frameTimes);
+        std::printf("%zu frames, mean %.3f ms (%.1f fps), p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+            stats.frames, stats.mean, stats.mean > 0.0 ? 1000.0 / stats.mean : 0.0,
+            stats.p50, stats.p95, stats.p99, stats.max);
+    }
+
+    // evicting runs the hooks, which free the storey meshes while bgfx is still up
+    building.clear_residency();
+    storeyMeshes.shutdown();
+
     //bgfx::destroy(ibh);
     bgfx::destroy(ibh_grid);
     bgfx::destroy(u_camera);
     bgfx::destroy(vbh);
     bgfx::destroy(vbh_grid);
-    bgfx::destroy(program);
-    bgfx::destroy(program_grid);
+    programs.shutdown();
 
     bgfx::shutdown();
     glfwDestroyWindow(window);
@@ -0,0 +1,103 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "core/raster.h"
+#include "utils/planLoader.h"
+#include "utils/pngWriter.h"
+
+// usage: plan_raster <plan_dir> <out_dir> [size]
+// renders a top down png for every .json plan in plan_dir without a gpu or display
+
+namespace fs = std::filesystem;
+
+int main(int argc, char ** argv)
+{
+    if (argc < 3)
+    {
+        std::fprintf(stderr, "usage: %s <plan_dir> <out_dir> [size]\n", argv[0]);
+        return 1;
+    }
+
+    fs::path planDir = argv[1];
+    fs::path outDir = argv[2];
+
+    lmcore::RasterOptions options;
+    if (argc > 3)
+    {
+        int size = std::atoi(argv[3]);
+        if (size <= 0)
+        {
+            std::fprintf(stderr, "plan_raster: bad size '%s'\n", argv[3]);
+            return 1;
+        }
+        options.width = options.height = (uint32_t)size;
+    }
+
+    std::error_code ec;
+    fs::create_directories(outDir, ec);
+
+    std::vector<fs::path> plans;
+    for (auto & entry : fs::directory_iterator(planDir, ec))
+    {
+        if (entry.is_regular_file() && entry.path().extension() == ".json")
+            plans.push_back(entry.path());
+    }
+    if (ec)
+    {
+        std::fprintf(stderr, "plan_raster: cannot read '%s'\n", planDir.string().c_str());
+        return 1;
+    }
+
+    using clock = std::chrono::steady_clock;
+    double loadMs = 0.0, rasterMs = 0.0, encodeMs = 0.0;
+    size_t written = 0;
+    size_t failed = 0;
+    auto start = clock::now();
+
+    for (auto & path : plans)
+    {
+        auto t0 = clock::now();
+        lmcore::FloorPlan plan;
+        try
+        {
+            plan = lmv::load_floor_plan_from_json(path.string());
+        }
+        catch (const std::exception & e)
+        {
+            // one malformed plan should not abort the whole batch
+            std::fprintf(stderr, "plan_raster: failed to load '%s': %s\n", path.string().c_str(), e.what());
+            failed++;
+            continue;
+        }
+        auto t1 = clock::now();
+        auto image = lmcore::rasterize_floor_plan(plan, options);
+        auto t2 = clock::now();
+        auto out = (outDir / path.stem()).string() + ".png";
+        bool ok = lmv::write_png(out, image.data(), image.width, image.height);
+        auto t3 = clock::now();
+
+        loadMs += std::chrono::duration<double, std::milli>(t1 - t0).count();
+        rasterMs += std::chrono::duration<double, std::milli>(t2 - t1).count();
+        encodeMs += std::chrono::duration<double, std::milli>(t3 - t2).count();
+
+        if (!ok)
+        {
+            std::fprintf(stderr, "plan_raster: failed to write '%s'\n", out.c_str());
+            failed++;
+            continue;
+        }
+        written++;
+    }
+
+    double total = std::chrono::duration<double>(clock::now() - start).count();
+    std::printf("%zu/%zu images %ux%u in %.3f s, %.1f images/sec, %zu failed (load %.1f ms, raster %.1f ms, png %.1f ms)\n",
+        written, plans.size(), options.width, options.height, total,
+        total > 0.0 ? double(written) / total : 0.0, failed, loadMs, rasterMs, encodeMs);
+
+    return written == plans.size() ? 0 : 1;
+}
\ No newline at end of file
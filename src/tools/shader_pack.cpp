@@ -0,0 +1,122 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "system/shaderArchive.h"
+
+// usage: shader_pack <archive> <profile>:<name>=<file> ...
+// packs compiled bgfx shader binaries into one archive, identical binaries are stored once
+
+struct PackInput
+{
+    std::string profile;
+    std::string name;
+    std::vector<uint8_t> bytes;
+};
+
+static bool readFile(const std::string & path, std::vector<uint8_t> & bytes)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+        return false;
+    std::streamsize size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    bytes.resize((size_t)size);
+    return size == 0 || (bool)file.read((char *)bytes.data(), size);
+}
+
+static bool parseInput(const std::string & arg, PackInput & input)
+{
+    auto colon = arg.find(':');
+    auto equals = arg.find('=', colon == std::string::npos ? 0 : colon);
+    if (colon == std::string::npos || equals == std::string::npos)
+        return false;
+
+    input.profile = arg.substr(0, colon);
+    input.name = arg.substr(colon + 1, equals - colon - 1);
+    if (input.profile.size() >= sizeof(lmv::ShaderArchiveEntry::profile) ||
+        input.name.size() >= sizeof(lmv::ShaderArchiveEntry::name))
+        return false;
+
+    return readFile(arg.substr(equals + 1), input.bytes);
+}
+
+int main(int argc, char ** argv)
+{
+    if (argc < 3)
+    {
+        std::fprintf(stderr, "usage: %s <archive> <profile>:<name>=<file> ...\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<PackInput> inputs(argc - 2);
+    for (int i = 2; i < argc; i++)
+    {
+        if (!parseInput(argv[i], inputs[i - 2]))
+        {
+            std::fprintf(stderr, "shader_pack: bad input '%s'\n", argv[i]);
+            return 1;
+        }
+    }
+
+    const uint32_t align = 16;
+    auto alignUp = [align](size_t v) { return (v + align - 1) & ~size_t(align - 1); };
+
+    lmv::ShaderArchiveHeader header = {};
+    header.magic = lmv::kShaderArchiveMagic;
+    header.version = lmv::kShaderArchiveVersion;
+    header.entryCount = (uint32_t)inputs.size();
+
+    std::vector<lmv::ShaderArchiveEntry> entries(inputs.size());
+    std::vector<size_t> blobs;
+    size_t offset = alignUp(sizeof(header) + entries.size() * sizeof(lmv::ShaderArchiveEntry));
+
+    for (size_t i = 0; i < inputs.size(); i++)
+    {
+        auto & e = entries[i];
+        std::memset(&e, 0, sizeof(e));
+        std::memcpy(e.profile, inputs[i].profile.data(), inputs[i].profile.size());
+        std::memcpy(e.name, inputs[i].name.data(), inputs[i].name.size());
+        e.size = (uint32_t)inputs[i].bytes.size();
+
+        bool shared = false;
+        for (size_t b : blobs)
+        {
+            if (inputs[b].bytes == inputs[i].bytes)
+            {
+                e.offset = entries[b].offset;
+                shared = true;
+                break;
+            }
+        }
+        if (shared)
+            continue;
+
+        e.offset = (uint32_t)offset;
+        offset = alignUp(offset + e.size);
+        blobs.push_back(i);
+    }
+
+    std::ofstream out(argv[1], std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+    {
+        std::fprintf(stderr, "shader_pack: cannot write '%s'\n", argv[1]);
+        return 1;
+    }
+
+    std::vector<uint8_t> image(offset, 0);
+    std::memcpy(image.data(), &header, sizeof(header));
+    std::memcpy(image.data() + sizeof(header), entries.data(), entries.size() * sizeof(lmv::ShaderArchiveEntry));
+    for (size_t b : blobs)
+    {
+        if (!inputs[b].bytes.empty())
+            std::memcpy(image.data() + entries[b].offset, inputs[b].bytes.data(), inputs[b].bytes.size());
+    }
+    out.write((const char *)image.data(), (std::streamsize)image.size());
+
+    std::printf("shader_pack: %zu shaders, %zu unique, %zu bytes -> %s\n", inputs.size(), blobs.size(), image.size(), argv[1]);
+    return out.good() ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,257 @@
+#include "building.h"
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <iostream>
+
+#include "utils/planLoader.h"
+
+namespace lmv
+{
+    size_t estimate_plan_bytes(const lmcore::FloorPlan & plan)
+    {
+        size_t bytes = sizeof(lmcore::FloorPlan);
+        bytes += plan.rooms.capacity() * sizeof(lmcore::FPRoom);
+        for(auto & room : plan.rooms)
+        {
+            bytes += room.name.capacity();
+            bytes += room.geometries.capacity() * sizeof(lmcore::FPGeometry);
+            for(auto & geo : room.geometries)
+                bytes += geo.points.capacity() * sizeof(lmcore::FPPoint);
+        }
+        bytes += plan.openings.capacity() * sizeof(lmcore::FPOpening);
+        for(auto & opening : plan.openings)
+            bytes += opening.name.capacity();
+        bytes += plan.data.room_metrics.capacity() * sizeof(lmcore::FPRoomMetrics);
+        bytes += plan.room_names.memory_bytes();
+        return bytes;
+    }
+
+    Building::Building(const BuildingOptions & options)
+        : options(options)
+    {
+        stats.budget_bytes = options.memory_budget;
+        uint32_t count = std::max(options.loader_threads, 1u);
+        for(uint32_t i = 0; i < count; i++)
+            workers.emplace_back([this]() { worker_loop(); });
+    }
+
+    Building::~Building()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for(auto & w : workers)
+            w.join();
+    }
+
+    uint32_t Building::add_storey(const std::string & path, float elevation)
+    {
+        // workers read storey paths under the lock
+        std::lock_guard<std::mutex> lock(mutex);
+        Storey storey;
+        storey.path = path;
+        storey.elevation = elevation;
+        storeys.push_back(std::move(storey));
+        uint32_t index = uint32_t(storeys.size() - 1);
+        by_elevation.push_back(index);
+        sorted = false;
+        stats.storeys = uint32_t(storeys.size());
+        return index;
+    }
+
+    void Building::worker_loop()
+    {
+        while(true)
+        {
+            uint32_t index;
+            std::string path;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this]() { return stopping || !requests.empty(); });
+                if(stopping)
+                    return;
+                index = requests.front();
+                requests.pop_front();
+                path = storeys[index].path;
+                in_flight++;
+            }
+
+            // an exception escaping the worker would terminate the process and leave in_flight counted
+            std::unique_ptr<lmcore::FloorPlan> plan;
+            try
+            {
+                plan = std::make_unique<lmcore::FloorPlan>(load_floor_plan_from_json(path));
+            }
+            catch(const std::exception & e)
+            {
+                std::cerr << path << ": " << e.what() << std::endl;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                completed.push_back({index, std::move(plan)});
+                in_flight--;
+            }
+            wake.notify_all();
+        }
+    }
+
+    void Building::lru_unlink(uint32_t storey)
+    {
+        auto & s = storeys[storey];
+        if(s.prev != k_none)
+            storeys[s.prev].next = s.next;
+        else if(lru_head == storey)
+            lru_head = s.next;
+        if(s.next != k_none)
+            storeys[s.next].prev = s.prev;
+        else if(lru_tail == storey)
+            lru_tail = s.prev;
+        s.prev = s.next = k_none;
+    }
+
+    void Building::lru_push_front(uint32_t storey)
+    {
+        auto & s = storeys[storey];
+        s.prev = k_none;
+        s.next = lru_head;
+        if(lru_head != k_none)
+            storeys[lru_head].prev = storey;
+        lru_head = storey;
+        if(lru_tail == k_none)
+            lru_tail = storey;
+    }
+
+    void Building::evict(uint32_t storey)
+    {
+        auto & s = storeys[storey];
+        if(hooks.on_evict)
+            hooks.on_evict(storey);
+        lru_unlink(storey);
+        s.plan.reset();
+        stats.resident_bytes -= s.bytes;
+        stats.resident--;
+        stats.evictions++;
+        s.bytes = 0;
+        s.state = EResidency::Unloaded;
+    }
+
+    void Building::update(const lmcore::Vec3f & camera_pos)
+    {
+        frame++;
+
+        if(!sorted)
+        {
+            std::sort(by_elevation.begin(), by_elevation.end(), [this](uint32_t a, uint32_t b)
+            {
+                return storeys[a].elevation < storeys[b].elevation;
+            });
+            sorted = true;
+        }
+
+        float lo = camera_pos.z() - options.resident_radius;
+        float hi = camera_pos.z() + options.resident_radius;
+        auto first = std::lower_bound(by_elevation.begin(), by_elevation.end(), lo, [this](uint32_t s, float v)
+        {
+            return storeys[s].elevation < v;
+        });
+
+        std::vector<uint32_t> wanted;
+        for(auto it = first; it != by_elevation.end() && storeys[*it].elevation <= hi; ++it)
+        {
+            auto & s = storeys[*it];
+            s.used_frame = frame;
+            if(s.state == EResidency::Resident)
+            {
+                stats.hits++;
+                lru_unlink(*it);
+                lru_push_front(*it);
+            }
+            else if(s.state == EResidency::Unloaded)
+            {
+                stats.misses++;
+                s.state = EResidency::Pending;
+                wanted.push_back(*it);
+            }
+        }
+
+        std::vector<Completed> done;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            // requests the camera moved away from go back to unloaded before a worker picks them up
+            auto keep = std::remove_if(requests.begin(), requests.end(), [this](uint32_t s)
+            {
+                if(storeys[s].used_frame == frame)
+                    return false;
+                storeys[s].state = EResidency::Unloaded;
+                return true;
+            });
+            requests.erase(keep, requests.end());
+            requests.insert(requests.end(), wanted.begin(), wanted.end());
+            done.swap(completed);
+            stats.pending = uint32_t(requests.size()) + in_flight;
+        }
+        if(!wanted.empty())
+            wake.notify_all();
+
+        for(auto & c : done)
+        {
+            auto & s = storeys[c.storey];
+            if(s.state != EResidency::Pending)
+                continue;
+            if(!c.plan)
+            {
+                s.state = EResidency::Failed;
+                stats.failed++;
+                continue;
+            }
+            s.plan = std::move(c.plan);
+            s.bytes = estimate_plan_bytes(*s.plan);
+            if(hooks.on_resident)
+                s.bytes += hooks.on_resident(c.storey, *s.plan, s.elevation);
+            s.state = EResidency::Resident;
+            stats.resident_bytes += s.bytes;
+            stats.resident++;
+            stats.loads++;
+            lru_push_front(c.storey);
+        }
+
+        // storeys used this frame are never evicted, even when they alone exceed the budget
+        while(stats.resident_bytes > options.memory_budget && lru_tail != k_none && storeys[lru_tail].used_frame != frame)
+            evict(lru_tail);
+    }
+
+    void Building::clear_residency()
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            for(auto s : requests)
+                storeys[s].state = EResidency::Unloaded;
+            requests.clear();
+            wake.wait(lock, [this]() { return in_flight == 0; });
+            for(auto & c : completed)
+                storeys[c.storey].state = EResidency::Unloaded;
+            completed.clear();
+            stats.pending = 0;
+        }
+
+        for(auto & s : storeys)
+        {
+            if(s.state == EResidency::Failed)
+                s.state = EResidency::Unloaded;
+        }
+        stats.failed = 0;
+
+        while(lru_tail != k_none)
+            evict(lru_tail);
+    }
+
+    BuildingStats Building::get_stats() const
+    {
+        return stats;
+    }
+}
\ No newline at end of file
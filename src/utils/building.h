@@ -0,0 +1,133 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/data.h"
+
+namespace lmv
+{
+    struct BuildingOptions
+    {
+        // plan data plus whatever on_resident reports for gpu buffers
+        size_t memory_budget = size_t(256) << 20;
+        // storeys whose elevation is within this distance of the camera are kept resident
+        float resident_radius = 10.f;
+        uint32_t loader_threads = 2;
+    };
+
+    // called from update(), so they run on the render thread and may create or destroy bgfx buffers
+    struct BuildingResidencyHooks
+    {
+        // returns the gpu bytes created for the storey
+        std::function<size_t(uint32_t storey, const lmcore::FloorPlan & plan, float elevation)> on_resident;
+        std::function<void(uint32_t storey)> on_evict;
+    };
+
+    struct BuildingStats
+    {
+        uint32_t storeys = 0;
+        uint32_t resident = 0;
+        uint32_t pending = 0;
+        // storeys whose plan failed to load, retried after clear_residency
+        uint32_t failed = 0;
+        size_t resident_bytes = 0;
+        size_t budget_bytes = 0;
+
+        uint64_t loads = 0;
+        uint64_t evictions = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+    };
+
+    size_t estimate_plan_bytes(const lmcore::FloorPlan & plan);
+
+    // many storeys (or whole plans) stacked by elevation. only storeys near the camera are resident,
+    // the rest are loaded asynchronously and evicted least recently used first once over budget
+    class Building
+    {
+    public:
+        explicit Building(const BuildingOptions & options = {});
+        ~Building();
+
+        Building(const Building &) = delete;
+        Building & operator=(const Building &) = delete;
+
+        uint32_t add_storey(const std::string & path, float elevation);
+        void set_hooks(BuildingResidencyHooks hooks) { this->hooks = std::move(hooks); }
+
+        // requests storeys near the camera, finalizes finished loads and evicts over budget
+        void update(const lmcore::Vec3f & camera_pos);
+        // unloads everything and waits for in flight loads
+        void clear_residency();
+
+        uint32_t get_storey_count() const { return uint32_t(storeys.size()); }
+        float get_elevation(uint32_t storey) const { return storeys[storey].elevation; }
+        // nullptr while the storey is not resident
+        const lmcore::FloorPlan * get_plan(uint32_t storey) const { return storeys[storey].plan.get(); }
+        bool has_failed(uint32_t storey) const { return storeys[storey].state == EResidency::Failed; }
+        BuildingStats get_stats() const;
+
+    private:
+        static constexpr uint32_t k_none = 0xffffffffu;
+
+        enum class EResidency
+        {
+            Unloaded = 0,
+            Pending,
+            Resident,
+            Failed
+        };
+
+        struct Storey
+        {
+            std::string path;
+            float elevation = 0.f;
+            EResidency state = EResidency::Unloaded;
+            std::unique_ptr<lmcore::FloorPlan> plan;
+            size_t bytes = 0;
+            uint64_t used_frame = 0;
+            // lru list, most recent at the head
+            uint32_t prev = k_none;
+            uint32_t next = k_none;
+        };
+
+        struct Completed
+        {
+            uint32_t storey;
+            // nullptr if loading threw
+            std::unique_ptr<lmcore::FloorPlan> plan;
+        };
+
+        void worker_loop();
+        void lru_unlink(uint32_t storey);
+        void lru_push_front(uint32_t storey);
+        void evict(uint32_t storey);
+
+        BuildingOptions options;
+        BuildingResidencyHooks hooks;
+        std::vector<Storey> storeys;
+        // storey indices sorted by elevation, rebuilt lazily after add_storey
+        std::vector<uint32_t> by_elevation;
+        bool sorted = true;
+
+        uint32_t lru_head = k_none;
+        uint32_t lru_tail = k_none;
+        uint64_t frame = 0;
+        BuildingStats stats;
+
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::deque<uint32_t> requests;
+        std::vector<Completed> completed;
+        uint32_t in_flight = 0;
+        bool stopping = false;
+        std::vector<std::thread> workers;
+    };
+}
\ No newline at end of file
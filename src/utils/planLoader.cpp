@@ -1 +1,118 @@
 #include "planLoader.h"
+
+#include <iostream>
+#include <fstream>
+#include <stdexcept>
+
+#include "core/enumNames.h"
+
+namespace lmv
+{
+    lmcore::ERoomType cast_room_type(const std::string & type)
+    {
+        return lmcore::room_type_from_name(type);
+    }
+
+    lmcore::EOpeningType cast_opening_type(const std::string & type)
+    {
+        return lmcore::opening_type_from_name(type);
+    }
+
+    namespace
+    {
+        // a missing array loads as empty, like indexing a non-const json used to
+        const js & array_or_empty(const js & obj, const char * key)
+        {
+            static const js empty = js::array();
+            auto it = obj.find(key);
+            return it != obj.end() ? *it : empty;
+        }
+    }
+
+    lmcore::FloorPlan parse_floor_plan(const js & jdata)
+    {
+        lmcore::FloorPlan plan;
+
+        const auto & rooms = array_or_empty(jdata, "rooms");
+        plan.rooms.reserve(rooms.size());
+        for(const auto & r : rooms)
+        {
+            lmcore::FPRoom rm;
+            rm.name = r.at("name").get<std::string>();
+            rm.type = cast_room_type(r.at("type").get_ref<const std::string &>());
+
+            const auto & geo = r.at("geometry");
+            rm.geometries.reserve(geo.size());
+            for(const auto & _g : geo)
+            {
+                lmcore::FPGeometry g;
+                g.points.reserve(_g.size());
+                for(const auto & _p : _g)
+                {
+                    lmcore::FPPoint p;
+                    p.value.x() = _p.at(0).get<float>();
+                    p.value.y() = _p.at(1).get<float>();
+                    p.value.z() = 0.0f;
+                    g.points.push_back(p);
+                }
+                rm.geometries.push_back(std::move(g));
+            }
+            plan.rooms.push_back(std::move(rm));
+        }
+
+        lmcore::build_room_index(plan);
+
+        const auto & openings = array_or_empty(jdata, "openings");
+        plan.openings.reserve(openings.size());
+        for(const auto & o : openings)
+        {
+            const auto & position = o.at("position");
+            const auto & crooms = array_or_empty(o, "connected_rooms");
+
+            lmcore::FPOpening opening;
+            opening.name = o.at("name").get<std::string>();
+            opening.type = cast_opening_type(o.at("type").get_ref<const std::string &>());
+
+            if(crooms.size()==1)
+            {
+                opening.connection.first = lmcore::find_room(plan, crooms.at(0).get_ref<const std::string &>());
+                opening.connection.out = true;
+            }
+            else if(crooms.size()==2)
+            {
+                opening.connection.first = lmcore::find_room(plan, crooms.at(0).get_ref<const std::string &>());
+                opening.connection.second = lmcore::find_room(plan, crooms.at(1).get_ref<const std::string &>());
+                opening.connection.out = false;
+            }
+            else
+            {
+                // left unconnected, reported as dangling by lmcore::validate_floor_plan
+            }
+
+            float x1 = position.at(0).get<float>();
+            float x2 = position.at(2).get<float>();
+            float y1 = position.at(1).get<float>();
+            float y2 = position.at(3).get<float>();
+            float tempz_h = 2.2f;
+
+            opening.position.value = lmcore::Vec3f{(x1+x2)/2.f,(y1+y2)/2.f,0.f};
+            lmcore::BBox bbox;
+            bbox.xyz = lmcore::Vec3f((x2-x1)/2.f,(y2-y1)/2.f,tempz_h/2.f);
+            bbox.transform.setIdentity();
+            opening.bounding = bbox;
+
+            plan.openings.push_back(std::move(opening));
+        }
+        return plan;
+    }
+
+    lmcore::FloorPlan load_floor_plan_from_json(const std::string & path)
+    {
+        std::ifstream file(path);
+        if (!file.is_open())
+            throw std::runtime_error("cannot open " + path);
+        js jdata;
+        file >> jdata;
+        return parse_floor_plan(jdata);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,546 @@
+#include "planWriter.h"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+
+#include "core/enumNames.h"
+#include "core/parallel.h"
+#include "core/processor.h"
+
+namespace lmv
+{
+    namespace
+    {
+        static_assert(std::endian::native == std::endian::little, "the binary plan form is written with memcpy and assumes little endian");
+
+        constexpr char k_binary_magic[4] = {'L', 'M', 'F', 'P'};
+        constexpr uint32_t k_binary_version = 1;
+        constexpr uint32_t k_flag_metrics = 1u << 0;
+
+        // runs fn(chunk, out) for every chunk of [0,count), chunks are formatted on worker threads
+        // and joined in order so the output does not depend on the thread count
+        template<typename Buffer, typename F>
+        std::vector<Buffer> format_chunks(size_t count, const PlanWriteOptions & options, F && fn)
+        {
+            size_t chunk_size = std::max<size_t>(options.chunk_size, 1);
+            size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+            std::vector<Buffer> chunks(chunk_count);
+
+            auto work = [&](size_t begin, size_t end, uint32_t)
+            {
+                for(size_t c = begin; c < end; c++)
+                    fn(c * chunk_size, std::min(count, (c + 1) * chunk_size), chunks[c]);
+            };
+
+            if(options.parallel)
+                lmcore::parallel_for(chunk_count, work, 1);
+            else
+                work(0, chunk_count, 0);
+            return chunks;
+        }
+
+        const std::vector<lmcore::FPRoomMetrics> * select_metrics(const lmcore::FloorPlan & plan, const PlanWriteOptions & options,
+            std::vector<lmcore::FPRoomMetrics> & scratch)
+        {
+            if(!options.metrics)
+                return nullptr;
+            if(plan.data.metrics_valid && plan.data.room_metrics.size() == plan.rooms.size())
+                return &plan.data.room_metrics;
+            lmcore::compute_room_metrics(plan, scratch, options.parallel);
+            return &scratch;
+        }
+
+        bool valid_room(const lmcore::FloorPlan & plan, int32_t room)
+        {
+            return room >= 0 && size_t(room) < plan.rooms.size();
+        }
+
+        // json
+
+        void append_float(std::string & out, float v)
+        {
+            if(!std::isfinite(v))
+                v = 0.f;
+            char buf[32];
+            auto res = std::to_chars(buf, buf + sizeof(buf), v);
+            out.append(buf, res.ptr);
+        }
+
+        void append_uint(std::string & out, uint32_t v)
+        {
+            char buf[16];
+            auto res = std::to_chars(buf, buf + sizeof(buf), v);
+            out.append(buf, res.ptr);
+        }
+
+        void append_string(std::string & out, std::string_view s)
+        {
+            static const char hex[] = "0123456789abcdef";
+
+            out.push_back('"');
+            for(char c : s)
+            {
+                switch(c)
+                {
+                case '"': out.append("\\\""); break;
+                case '\\': out.append("\\\\"); break;
+                case '\n': out.append("\\n"); break;
+                case '\r': out.append("\\r"); break;
+                case '\t': out.append("\\t"); break;
+                default:
+                    if(uint8_t(c) < 0x20)
+                    {
+                        out.append("\\u00");
+                        out.push_back(hex[uint8_t(c) >> 4]);
+                        out.push_back(hex[uint8_t(c) & 0xf]);
+                    }
+                    else
+                    {
+                        out.push_back(c);
+                    }
+                }
+            }
+            out.push_back('"');
+        }
+
+        void append_room_json(std::string & out, const lmcore::FPRoom & room, const lmcore::FPRoomMetrics * metrics)
+        {
+            out.append("{\"name\":");
+            append_string(out, room.name);
+            out.append(",\"type\":");
+            append_string(out, lmcore::k_room_type_names.name_of(room.type));
+
+            out.append(",\"geometry\":[");
+            for(size_t g = 0; g < room.geometries.size(); g++)
+            {
+                if(g > 0)
+                    out.push_back(',');
+                out.push_back('[');
+                const auto & points = room.geometries[g].points;
+                for(size_t i = 0; i < points.size(); i++)
+                {
+                    if(i > 0)
+                        out.push_back(',');
+                    out.push_back('[');
+                    append_float(out, points[i].value.x());
+                    out.push_back(',');
+                    append_float(out, points[i].value.y());
+                    out.push_back(']');
+                }
+                out.push_back(']');
+            }
+            out.push_back(']');
+
+            if(metrics)
+            {
+                out.append(",\"metrics\":{\"area\":");
+                append_float(out, metrics->area);
+                out.append(",\"perimeter\":");
+                append_float(out, metrics->perimeter);
+                out.append(",\"centroid\":[");
+                append_float(out, metrics->centroid.x());
+                out.push_back(',');
+                append_float(out, metrics->centroid.y());
+                out.append("],\"window_area\":");
+                append_float(out, metrics->window_area);
+                out.append(",\"window_to_floor\":");
+                append_float(out, metrics->window_to_floor);
+                out.append(",\"door_count\":");
+                append_uint(out, metrics->door_count);
+                out.append(",\"window_count\":");
+                append_uint(out, metrics->window_count);
+                out.push_back('}');
+            }
+            out.push_back('}');
+        }
+
+        void append_opening_json(std::string & out, const lmcore::FloorPlan & plan, const lmcore::FPOpening & opening)
+        {
+            const lmcore::Vec3f & c = opening.position.value;
+            const lmcore::Vec3f & h = opening.bounding.xyz;
+
+            out.append("{\"name\":");
+            append_string(out, opening.name);
+            out.append(",\"type\":");
+            append_string(out, lmcore::k_opening_type_names.name_of(opening.type));
+
+            // the loader stores the center and half extents of [x1, y1, x2, y2]
+            out.append(",\"position\":[");
+            append_float(out, c.x() - h.x());
+            out.push_back(',');
+            append_float(out, c.y() - h.y());
+            out.push_back(',');
+            append_float(out, c.x() + h.x());
+            out.push_back(',');
+            append_float(out, c.y() + h.y());
+
+            // the number of names decides out on reload, so it follows the connection and not which rooms
+            // are valid. dangling rooms are written as "" and reload dangling for the validator to report
+            out.append("],\"connected_rooms\":[");
+            const auto & conn = opening.connection;
+            auto append_room = [&](int32_t room)
+            {
+                append_string(out, valid_room(plan, room) ? std::string_view(plan.rooms[room].name) : std::string_view());
+            };
+            if(conn.out)
+            {
+                append_room(conn.first);
+            }
+            else if(conn.first >= 0 || conn.second >= 0)
+            {
+                append_room(conn.first);
+                out.push_back(',');
+                append_room(conn.second);
+            }
+            out.append("]}");
+        }
+
+        void join_chunks(std::string & out, const std::vector<std::string> & chunks)
+        {
+            bool first = true;
+            for(const auto & chunk : chunks)
+            {
+                if(chunk.empty())
+                    continue;
+                if(!first)
+                    out.push_back(',');
+                out.append(chunk);
+                first = false;
+            }
+        }
+
+        // binary
+
+        template<typename T>
+        void put(std::vector<uint8_t> & out, T v)
+        {
+            size_t at = out.size();
+            out.resize(at + sizeof(T));
+            std::memcpy(out.data() + at, &v, sizeof(T));
+        }
+
+        void put_string(std::vector<uint8_t> & out, std::string_view s)
+        {
+            put(out, uint32_t(s.size()));
+            out.insert(out.end(), s.begin(), s.end());
+        }
+
+        void put_room(std::vector<uint8_t> & out, const lmcore::FPRoom & room)
+        {
+            put_string(out, room.name);
+            // unknown types are kept as ENUM_MAX, the loader accepts them and the validator reports them
+            put(out, uint8_t(std::min(room.type, lmcore::ERoomType::ENUM_MAX)));
+            put(out, uint32_t(room.geometries.size()));
+            for(const auto & geo : room.geometries)
+            {
+                put(out, uint32_t(geo.points.size()));
+                for(const auto & p : geo.points)
+                {
+                    put(out, p.value.x());
+                    put(out, p.value.y());
+                    put(out, p.value.z());
+                }
+            }
+        }
+
+        void put_opening(std::vector<uint8_t> & out, const lmcore::FPOpening & opening)
+        {
+            put_string(out, opening.name);
+            put(out, uint8_t(std::min(opening.type, lmcore::EOpeningType::ENUM_MAX)));
+            for(int i = 0; i < 3; i++)
+                put(out, opening.position.value[i]);
+            for(int i = 0; i < 3; i++)
+                put(out, opening.bounding.xyz[i]);
+            put(out, opening.connection.first);
+            put(out, opening.connection.second);
+            put(out, uint8_t(opening.connection.out ? 1 : 0));
+        }
+
+        struct Reader
+        {
+            const uint8_t * p;
+            const uint8_t * end;
+            bool ok = true;
+
+            size_t remaining() const { return size_t(end - p); }
+
+            template<typename T>
+            T get()
+            {
+                T v{};
+                if(remaining() < sizeof(T))
+                {
+                    ok = false;
+                    p = end;
+                    return v;
+                }
+                std::memcpy(&v, p, sizeof(T));
+                p += sizeof(T);
+                return v;
+            }
+
+            std::string get_string()
+            {
+                uint32_t n = get<uint32_t>();
+                if(remaining() < n)
+                {
+                    ok = false;
+                    p = end;
+                    return {};
+                }
+                std::string s(reinterpret_cast<const char *>(p), n);
+                p += n;
+                return s;
+            }
+
+            // rejects counts that could not fit in the remaining bytes before anything is reserved
+            uint32_t get_count(size_t min_item_bytes)
+            {
+                uint32_t n = get<uint32_t>();
+                if(size_t(n) * min_item_bytes > remaining())
+                {
+                    ok = false;
+                    p = end;
+                    return 0;
+                }
+                return n;
+            }
+        };
+
+        bool write_file(const std::string & path, const void * data, size_t size)
+        {
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            if(!file.is_open())
+            {
+                std::cerr << path << std::endl;
+                return false;
+            }
+            file.write(static_cast<const char *>(data), std::streamsize(size));
+            return bool(file);
+        }
+    }
+
+    std::string serialize_floor_plan_json(const lmcore::FloorPlan & plan, const PlanWriteOptions & options)
+    {
+        std::vector<lmcore::FPRoomMetrics> scratch;
+        const auto * metrics = select_metrics(plan, options, scratch);
+
+        auto rooms = format_chunks<std::string>(plan.rooms.size(), options, [&](size_t begin, size_t end, std::string & out)
+        {
+            for(size_t r = begin; r < end; r++)
+            {
+                if(r > begin)
+                    out.push_back(',');
+                append_room_json(out, plan.rooms[r], metrics ? &(*metrics)[r] : nullptr);
+            }
+        });
+
+        auto openings = format_chunks<std::string>(plan.openings.size(), options, [&](size_t begin, size_t end, std::string & out)
+        {
+            for(size_t o = begin; o < end; o++)
+            {
+                if(o > begin)
+                    out.push_back(',');
+                append_opening_json(out, plan, plan.openings[o]);
+            }
+        });
+
+        size_t total = 32;
+        for(const auto & chunk : rooms)
+            total += chunk.size() + 1;
+        for(const auto & chunk : openings)
+            total += chunk.size() + 1;
+
+        std::string out;
+        out.reserve(total);
+        out.append("{\"rooms\":[");
+        join_chunks(out, rooms);
+        out.append("],\"openings\":[");
+        join_chunks(out, openings);
+        out.append("]}");
+        return out;
+    }
+
+    bool write_floor_plan_json(const std::string & path, const lmcore::FloorPlan & plan, const PlanWriteOptions & options)
+    {
+        std::string text = serialize_floor_plan_json(plan, options);
+        return write_file(path, text.data(), text.size());
+    }
+
+    std::vector<uint8_t> serialize_floor_plan_binary(const lmcore::FloorPlan & plan, const PlanWriteOptions & options)
+    {
+        std::vector<lmcore::FPRoomMetrics> scratch;
+        const auto * metrics = select_metrics(plan, options, scratch);
+
+        auto rooms = format_chunks<std::vector<uint8_t>>(plan.rooms.size(), options, [&](size_t begin, size_t end, std::vector<uint8_t> & out)
+        {
+            for(size_t r = begin; r < end; r++)
+                put_room(out, plan.rooms[r]);
+        });
+
+        auto openings = format_chunks<std::vector<uint8_t>>(plan.openings.size(), options, [&](size_t begin, size_t end, std::vector<uint8_t> & out)
+        {
+            for(size_t o = begin; o < end; o++)
+                put_opening(out, plan.openings[o]);
+        });
+
+        size_t total = 20;
+        for(const auto & chunk : rooms)
+            total += chunk.size();
+        for(const auto & chunk : openings)
+            total += chunk.size();
+        if(metrics)
+            total += metrics->size() * 8 * sizeof(uint32_t);
+
+        std::vector<uint8_t> out;
+        out.reserve(total);
+        out.resize(sizeof(k_binary_magic));
+        std::memcpy(out.data(), k_binary_magic, sizeof(k_binary_magic));
+        put(out, k_binary_version);
+        put(out, metrics ? k_flag_metrics : 0u);
+        put(out, uint32_t(plan.rooms.size()));
+        put(out, uint32_t(plan.openings.size()));
+        for(const auto & chunk : rooms)
+            out.insert(out.end(), chunk.begin(), chunk.end());
+        for(const auto & chunk : openings)
+            out.insert(out.end(), chunk.begin(), chunk.end());
+
+        if(metrics)
+        {
+            for(const auto & m : *metrics)
+            {
+                put(out, m.area);
+                put(out, m.perimeter);
+                put(out, m.centroid.x());
+                put(out, m.centroid.y());
+                put(out, m.window_area);
+                put(out, m.window_to_floor);
+                put(out, m.door_count);
+                put(out, m.window_count);
+            }
+        }
+        return out;
+    }
+
+    bool write_floor_plan_binary(const std::string & path, const lmcore::FloorPlan & plan, const PlanWriteOptions & options)
+    {
+        auto bytes = serialize_floor_plan_binary(plan, options);
+        return write_file(path, bytes.data(), bytes.size());
+    }
+
+    bool parse_floor_plan_binary(const uint8_t * data, size_t size, lmcore::FloorPlan & plan)
+    {
+        plan = lmcore::FloorPlan();
+        if(size < sizeof(k_binary_magic) || std::memcmp(data, k_binary_magic, sizeof(k_binary_magic)) != 0)
+            return false;
+
+        Reader in{data + sizeof(k_binary_magic), data + size};
+        uint32_t version = in.get<uint32_t>();
+        uint32_t flags = in.get<uint32_t>();
+        if(!in.ok || version != k_binary_version)
+            return false;
+
+        // smallest possible room and opening records
+        uint32_t room_count = in.get_count(9);
+        uint32_t opening_count = in.get<uint32_t>();
+
+        plan.rooms.resize(room_count);
+        for(auto & room : plan.rooms)
+        {
+            room.name = in.get_string();
+            uint8_t type = in.get<uint8_t>();
+            if(type > uint8_t(lmcore::ERoomType::ENUM_MAX))
+                in.ok = false;
+            room.type = lmcore::ERoomType(type);
+
+            room.geometries.resize(in.get_count(4));
+            for(auto & geo : room.geometries)
+            {
+                geo.points.resize(in.get_count(12));
+                for(auto & p : geo.points)
+                {
+                    p.value.x() = in.get<float>();
+                    p.value.y() = in.get<float>();
+                    p.value.z() = in.get<float>();
+                }
+            }
+            if(!in.ok)
+                break;
+        }
+
+        if(in.ok && size_t(opening_count) * 38 > in.remaining())
+            in.ok = false;
+        if(in.ok)
+            plan.openings.resize(opening_count);
+        for(auto & opening : plan.openings)
+        {
+            opening.name = in.get_string();
+            uint8_t type = in.get<uint8_t>();
+            if(type > uint8_t(lmcore::EOpeningType::ENUM_MAX))
+                in.ok = false;
+            opening.type = lmcore::EOpeningType(type);
+            for(int i = 0; i < 3; i++)
+                opening.position.value[i] = in.get<float>();
+            for(int i = 0; i < 3; i++)
+                opening.bounding.xyz[i] = in.get<float>();
+            opening.bounding.transform.setIdentity();
+            opening.connection.first = in.get<int32_t>();
+            opening.connection.second = in.get<int32_t>();
+            opening.connection.out = in.get<uint8_t>() != 0;
+            if(!in.ok)
+                break;
+        }
+
+        if(in.ok && (flags & k_flag_metrics))
+        {
+            auto & metrics = plan.data.room_metrics;
+            metrics.resize(room_count);
+            for(auto & m : metrics)
+            {
+                m.area = in.get<float>();
+                m.perimeter = in.get<float>();
+                m.centroid.x() = in.get<float>();
+                m.centroid.y() = in.get<float>();
+                m.window_area = in.get<float>();
+                m.window_to_floor = in.get<float>();
+                m.door_count = in.get<uint32_t>();
+                m.window_count = in.get<uint32_t>();
+            }
+            plan.data.metrics_valid = in.ok;
+        }
+
+        if(!in.ok)
+        {
+            plan = lmcore::FloorPlan();
+            return false;
+        }
+
+        lmcore::build_room_index(plan);
+        return true;
+    }
+
+    lmcore::FloorPlan load_floor_plan_from_binary(const std::string & path)
+    {
+        lmcore::FloorPlan plan;
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if(!file.is_open())
+        {
+            std::cerr << path << std::endl;
+            return plan;
+        }
+
+        std::vector<uint8_t> bytes(size_t(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char *>(bytes.data()), std::streamsize(bytes.size()));
+
+        if(!file || !parse_floor_plan_binary(bytes.data(), bytes.size(), plan))
+            std::cerr << path << std::endl;
+        return plan;
+    }
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "core/data.h"
+
+namespace lmv
+{
+    struct PlanWriteOptions
+    {
+        // adds a "metrics" object to every room, taken from plan.data or computed if not cached
+        bool metrics = true;
+        // rooms and openings are formatted in chunks of this size across threads
+        uint32_t chunk_size = 512;
+        bool parallel = true;
+    };
+
+    // same layout load_floor_plan_from_json reads, numbers are written with std::to_chars
+    std::string serialize_floor_plan_json(const lmcore::FloorPlan & plan, const PlanWriteOptions & options = {});
+    bool write_floor_plan_json(const std::string & path, const lmcore::FloorPlan & plan, const PlanWriteOptions & options = {});
+
+    // little endian "LMFP" binary form, keeps z coordinates, opening extents and cached metrics
+    std::vector<uint8_t> serialize_floor_plan_binary(const lmcore::FloorPlan & plan, const PlanWriteOptions & options = {});
+    bool write_floor_plan_binary(const std::string & path, const lmcore::FloorPlan & plan, const PlanWriteOptions & options = {});
+
+    // returns false and leaves plan empty if the data is truncated or not a plan
+    bool parse_floor_plan_binary(const uint8_t * data, size_t size, lmcore::FloorPlan & plan);
+    lmcore::FloorPlan load_floor_plan_from_binary(const std::string & path);
+}
@@ -0,0 +1,228 @@
+#include "pngWriter.h"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+
+namespace lmv
+{
+namespace
+{
+    const std::array<uint32_t, 256> & crc_table()
+    {
+        static const std::array<uint32_t, 256> table = []()
+        {
+            std::array<uint32_t, 256> t{};
+            for(uint32_t n = 0; n < 256; n++)
+            {
+                uint32_t c = n;
+                for(int k = 0; k < 8; k++)
+                    c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+                t[n] = c;
+            }
+            return t;
+        }();
+        return table;
+    }
+
+    uint32_t crc32(const uint8_t * data, size_t size, uint32_t crc = 0)
+    {
+        const auto & t = crc_table();
+        crc ^= 0xffffffffu;
+        for(size_t i = 0; i < size; i++)
+            crc = t[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+        return crc ^ 0xffffffffu;
+    }
+
+    uint32_t adler32(const uint8_t * data, size_t size)
+    {
+        uint32_t a = 1, b = 0;
+        while(size > 0)
+        {
+            // 5552 is the largest run before the sums can overflow
+            size_t run = std::min<size_t>(size, 5552);
+            for(size_t i = 0; i < run; i++)
+            {
+                a += data[i];
+                b += a;
+            }
+            a %= 65521;
+            b %= 65521;
+            data += run;
+            size -= run;
+        }
+        return (b << 16) | a;
+    }
+
+    struct BitWriter
+    {
+        std::vector<uint8_t> & out;
+        uint64_t bits = 0;
+        uint32_t count = 0;
+
+        void put(uint32_t value, uint32_t n)
+        {
+            bits |= uint64_t(value) << count;
+            count += n;
+            while(count >= 8)
+            {
+                out.push_back(uint8_t(bits));
+                bits >>= 8;
+                count -= 8;
+            }
+        }
+
+        // huffman codes are stored most significant bit first
+        void put_code(uint32_t code, uint32_t n)
+        {
+            uint32_t r = 0;
+            for(uint32_t i = 0; i < n; i++)
+                r |= ((code >> i) & 1) << (n - 1 - i);
+            put(r, n);
+        }
+
+        void flush()
+        {
+            if(count > 0)
+                out.push_back(uint8_t(bits));
+            bits = 0;
+            count = 0;
+        }
+    };
+
+    void put_literal(BitWriter & w, uint32_t sym)
+    {
+        if(sym < 144)
+            w.put_code(0x30 + sym, 8);
+        else if(sym < 256)
+            w.put_code(0x190 + sym - 144, 9);
+        else if(sym < 280)
+            w.put_code(sym - 256, 7);
+        else
+            w.put_code(0xc0 + sym - 280, 8);
+    }
+
+    const uint16_t k_length_base[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    const uint8_t k_length_extra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    const uint16_t k_dist_base[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+    const uint8_t k_dist_extra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+    void put_match(BitWriter & w, uint32_t length, uint32_t distance)
+    {
+        int l = 28;
+        while(k_length_base[l] > length)
+            l--;
+        put_literal(w, 257 + l);
+        w.put(length - k_length_base[l], k_length_extra[l]);
+
+        int d = 29;
+        while(k_dist_base[d] > distance)
+            d--;
+        w.put_code(d, 5);
+        w.put(distance - k_dist_base[d], k_dist_extra[d]);
+    }
+
+    void deflate_fixed(const std::vector<uint8_t> & raw, size_t stride, std::vector<uint8_t> & out)
+    {
+        BitWriter w{out};
+        w.put(1, 1); // last block
+        w.put(1, 2); // fixed huffman
+
+        // the previous pixel and the pixel above are the only match candidates
+        const size_t candidates[2] = {4, stride};
+        const size_t max_distance = 32768;
+        size_t n = raw.size();
+        size_t i = 0;
+        while(i < n)
+        {
+            size_t best_len = 0;
+            size_t best_dist = 0;
+            for(size_t d : candidates)
+            {
+                if(d == 0 || d > i || d > max_distance)
+                    continue;
+                size_t len = 0;
+                while(len < 258 && i + len < n && raw[i + len] == raw[i + len - d])
+                    len++;
+                if(len > best_len)
+                {
+                    best_len = len;
+                    best_dist = d;
+                }
+            }
+
+            if(best_len >= 3)
+            {
+                put_match(w, uint32_t(best_len), uint32_t(best_dist));
+                i += best_len;
+            }
+            else
+            {
+                put_literal(w, raw[i]);
+                i++;
+            }
+        }
+        put_literal(w, 256);
+        w.flush();
+    }
+
+    void put_u32_be(std::vector<uint8_t> & out, uint32_t v)
+    {
+        out.push_back(uint8_t(v >> 24));
+        out.push_back(uint8_t(v >> 16));
+        out.push_back(uint8_t(v >> 8));
+        out.push_back(uint8_t(v));
+    }
+
+    void put_chunk(std::vector<uint8_t> & out, const char * type, const std::vector<uint8_t> & data)
+    {
+        put_u32_be(out, uint32_t(data.size()));
+        size_t start = out.size();
+        out.insert(out.end(), type, type + 4);
+        out.insert(out.end(), data.begin(), data.end());
+        put_u32_be(out, crc32(out.data() + start, out.size() - start));
+    }
+}
+
+std::vector<uint8_t> encode_png(const uint8_t * rgba, uint32_t width, uint32_t height)
+{
+    size_t row_bytes = size_t(width) * 4;
+    size_t stride = row_bytes + 1;
+
+    std::vector<uint8_t> raw(stride * height);
+    for(uint32_t y = 0; y < height; y++)
+    {
+        raw[y * stride] = 0; // no filter
+        std::copy(rgba + y * row_bytes, rgba + (y + 1) * row_bytes, raw.begin() + y * stride + 1);
+    }
+
+    std::vector<uint8_t> idat = {0x78, 0x01};
+    deflate_fixed(raw, stride, idat);
+    put_u32_be(idat, adler32(raw.data(), raw.size()));
+
+    std::vector<uint8_t> ihdr;
+    put_u32_be(ihdr, width);
+    put_u32_be(ihdr, height);
+    ihdr.push_back(8); // bit depth
+    ihdr.push_back(6); // rgba
+    ihdr.push_back(0);
+    ihdr.push_back(0);
+    ihdr.push_back(0);
+
+    std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    put_chunk(png, "IHDR", ihdr);
+    put_chunk(png, "IDAT", idat);
+    put_chunk(png, "IEND", {});
+    return png;
+}
+
+bool write_png(const std::string & path, const uint8_t * rgba, uint32_t width, uint32_t height)
+{
+    auto png = encode_png(rgba, width, height);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if(!file.is_open())
+        return false;
+    file.write((const char *)png.data(), (std::streamsize)png.size());
+    return file.good();
+}
+}
\ No newline at end of file
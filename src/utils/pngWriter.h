@@ -0,0 +1,12 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace lmv
+{
+    // encodes 8 bit rgba pixels as png. the deflate stream uses fixed huffman codes and only
+    // looks for repeats of the previous pixel and the row above, which is what flat colored maps need
+    std::vector<uint8_t> encode_png(const uint8_t * rgba, uint32_t width, uint32_t height);
+    bool write_png(const std::string & path, const uint8_t * rgba, uint32_t width, uint32_t height);
+}
\ No newline at end of file